@@ -0,0 +1,1601 @@
+#include "HMMio.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+// Valor JSON mínimo: lo justo para leer archivos de modelo
+struct JsonValue {
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type;
+    bool boolean;
+    double number;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    JsonValue() : type(NUL), boolean(false), number(0.0) {}
+
+    const JsonValue* find(const std::string& key) const {
+        for (size_t i = 0; i < members.size(); i++) {
+            if (members[i].first == key) return &members[i].second;
+        }
+        return NULL;
+    }
+};
+
+class JsonParser {
+private:
+    const std::string& input;
+    size_t pos;
+
+    void fail(const std::string& message) const {
+        throw std::invalid_argument("JSON inválido en la posición " + std::to_string(pos) + ": " + message);
+    }
+
+    void skipSpace() {
+        while (pos < input.size() && (input[pos] == ' ' || input[pos] == '\t' || input[pos] == '\n' ||
+                                      input[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    void expect(char c) {
+        skipSpace();
+        if (pos >= input.size() || input[pos] != c) fail(std::string("se esperaba '") + c + "'");
+        pos++;
+    }
+
+    bool consume(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (input.compare(pos, length, literal) != 0) return false;
+        pos += length;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += (char)code;
+        } else if (code < 0x800) {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        } else {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (pos < input.size() && input[pos] != '"') {
+            char c = input[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= input.size()) break;
+            char escape = input[pos++];
+            switch (escape) {
+                case '"': case '\\': case '/': out += escape; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos + 4 > input.size()) fail("escape \\u incompleto");
+                    char* end;
+                    std::string hex = input.substr(pos, 4);
+                    unsigned code = (unsigned)std::strtoul(hex.c_str(), &end, 16);
+                    if (end != hex.c_str() + 4) fail("escape \\u inválido");
+                    appendUtf8(out, code);
+                    pos += 4;
+                    break;
+                }
+                default: fail("escape desconocido");
+            }
+        }
+        if (pos >= input.size()) fail("cadena sin terminar");
+        pos++;
+        return out;
+    }
+
+    JsonValue parseValue() {
+        skipSpace();
+        if (pos >= input.size()) fail("fin de archivo inesperado");
+
+        JsonValue value;
+        char c = input[pos];
+        if (c == '{') {
+            value.type = JsonValue::OBJECT;
+            pos++;
+            skipSpace();
+            if (pos < input.size() && input[pos] == '}') {
+                pos++;
+                return value;
+            }
+            do {
+                std::string key = parseString();
+                expect(':');
+                value.members.push_back(std::make_pair(key, parseValue()));
+                skipSpace();
+            } while (pos < input.size() && input[pos] == ',' && ++pos);
+            expect('}');
+        } else if (c == '[') {
+            value.type = JsonValue::ARRAY;
+            pos++;
+            skipSpace();
+            if (pos < input.size() && input[pos] == ']') {
+                pos++;
+                return value;
+            }
+            do {
+                value.items.push_back(parseValue());
+                skipSpace();
+            } while (pos < input.size() && input[pos] == ',' && ++pos);
+            expect(']');
+        } else if (c == '"') {
+            value.type = JsonValue::STRING;
+            value.text = parseString();
+        } else if (consume("true")) {
+            value.type = JsonValue::BOOLEAN;
+            value.boolean = true;
+        } else if (consume("false")) {
+            value.type = JsonValue::BOOLEAN;
+        } else if (consume("null")) {
+            value.type = JsonValue::NUL;
+        } else {
+            const char* start = input.c_str() + pos;
+            char* end;
+            value.type = JsonValue::NUMBER;
+            value.number = std::strtod(start, &end);
+            if (end == start) fail("valor inesperado");
+            pos += end - start;
+        }
+        return value;
+    }
+
+public:
+    explicit JsonParser(const std::string& text) : input(text), pos(0) {}
+
+    JsonValue parse() {
+        JsonValue value = parseValue();
+        skipSpace();
+        if (pos != input.size()) fail("contenido después del valor principal");
+        return value;
+    }
+};
+
+/**
+ * Lector de líneas sobre zlib; gzread también lee archivos sin comprimir.
+ * Cada línea se devuelve sin el salto (ni el '\r') como puntero al buffer
+ * interno, válido hasta la siguiente llamada.
+ */
+class GzLineReader {
+private:
+    gzFile file;
+    std::string path;
+    std::vector<char> buffer;
+    size_t begin, scanned, end;  // datos pendientes [begin, end); sin '\n' en [begin, scanned)
+    bool at_end;
+    size_t line_number;
+
+public:
+    explicit GzLineReader(const std::string& path)
+        : path(path), buffer(1 << 20), begin(0), scanned(0), end(0), at_end(false), line_number(0) {
+        file = gzopen(path.c_str(), "rb");
+        if (!file) {
+            throw std::runtime_error("No se pudo abrir el archivo: " + path);
+        }
+        gzbuffer(file, 1 << 17);
+    }
+
+    ~GzLineReader() {
+        gzclose(file);
+    }
+
+    bool next(const char*& line, size_t& length) {
+        for (;;) {
+            const char* newline = static_cast<const char*>(std::memchr(&buffer[scanned], '\n', end - scanned));
+            if (newline || (at_end && begin < end)) {
+                size_t line_end = newline ? newline - &buffer[0] : end;
+                line = &buffer[begin];
+                length = line_end - begin;
+                if (length > 0 && line[length - 1] == '\r') length--;
+                begin = scanned = newline ? line_end + 1 : end;
+                line_number++;
+                return true;
+            }
+            if (at_end) return false;
+
+            // Se conserva la línea a medias al principio del buffer y se lee más
+            std::memmove(&buffer[0], &buffer[begin], end - begin);
+            end -= begin;
+            scanned = end;
+            begin = 0;
+            if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+            int count = gzread(file, &buffer[end], buffer.size() - end);
+            int code = Z_OK;
+            // Un gzip truncado no da -1: gzread devuelve 0 con Z_BUF_ERROR
+            if (count <= 0) gzerror(file, &code);
+            if (count < 0 || code != Z_OK) {
+                const char* message = gzerror(file, &code);
+                throw std::runtime_error("Error al leer " + path + ": " +
+                                         (code == Z_BUF_ERROR ? "archivo gzip truncado" : message));
+            }
+            if (count == 0) at_end = true;
+            end += count;
+        }
+    }
+
+    // Número de la última línea devuelta (desde 1)
+    size_t lineNumber() const {
+        return line_number;
+    }
+};
+
+// Tamaño a partir del cual RegionWriter vuelca el buffer al archivo
+const size_t WRITE_BLOCK = 1 << 20;
+
+/**
+ * Escapa con %XX los caracteres no permitidos en GFF3: en el seqid sólo
+ * se admiten letras, dígitos y .:^*$@!+_?-|; en los valores de atributos,
+ * todo salvo caracteres de control y ;=&,%
+ */
+std::string gffEscape(const std::string& text, bool attribute) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = text[i];
+        bool allowed = attribute ? (c >= ' ' && c != 0x7f && !std::strchr(";=&,%", c))
+                                 : (std::isalnum(c) || (c > ' ' && c < 0x7f && std::strchr(".:^*$@!+_?-|", c)));
+        if (allowed) {
+            out += c;
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 15];
+        }
+    }
+    return out;
+}
+
+void appendNumber(std::string& out, size_t value) {
+    char digits[24];
+    int length = 0;
+    do {
+        digits[length++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    while (length > 0) out += digits[--length];
+}
+
+void checkStrand(char strand) {
+    if (strand != '+' && strand != '-' && strand != '.') {
+        throw std::invalid_argument(std::string("Hebra inválida '") + strand + "': debe ser '+', '-' o '.'");
+    }
+}
+
+// Archivo de resultados: cabecera, nombres de estados, registros e índice,
+// con cada sección alineada a 8 bytes
+const char RESULT_MAGIC[8] = {'H', 'M', 'M', 'R', 'E', 'S', 'U', 'L'};
+const uint32_t RESULT_VERSION = 1;
+
+struct ResultHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_states;
+    uint64_t fingerprint;
+    uint64_t num_records;
+    uint64_t index_offset;
+};
+static_assert(sizeof(ResultHeader) == 40, "cabecera sin relleno");
+
+// Entrada del índice: name_offset (en el bloque de nombres), name_length,
+// length, num_runs, runs_offset, rank_offset, probs_offset
+const size_t RESULT_ENTRY_WORDS = 7;
+
+// Índice de rango: por cada bloque de RANK_BLOCK posiciones, el número de
+// tramos que empiezan antes del bloque y un bitmap de los que empiezan en él
+const size_t RANK_BLOCK = 512;
+const size_t RANK_WORDS = 1 + RANK_BLOCK / 64;
+
+uint64_t aligned(uint64_t size) {
+    return (size + 7) & ~uint64_t(7);
+}
+
+uint64_t fnv1a(uint64_t hash, const void* bytes, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(bytes);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t fnv1a(uint64_t hash, const std::vector<std::string>& names) {
+    for (size_t i = 0; i < names.size(); i++) {
+        uint64_t length = names[i].size();
+        hash = fnv1a(hash, &length, sizeof(length));
+        hash = fnv1a(hash, names[i].data(), names[i].size());
+    }
+    return hash;
+}
+
+uint64_t fnv1a(uint64_t hash, const std::vector<double>& values) {
+    return fnv1a(hash, values.data(), values.size() * sizeof(double));
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+const JsonValue& member(const JsonValue& object, const std::string& key) {
+    const JsonValue* value = object.find(key);
+    if (!value) {
+        throw std::invalid_argument("Falta el campo \"" + key + "\" en el modelo");
+    }
+    return *value;
+}
+
+std::vector<std::string> stringList(const JsonValue& value, const std::string& key) {
+    if (value.type != JsonValue::ARRAY) {
+        throw std::invalid_argument("El campo \"" + key + "\" debe ser una lista de cadenas");
+    }
+    std::vector<std::string> out;
+    for (size_t i = 0; i < value.items.size(); i++) {
+        if (value.items[i].type != JsonValue::STRING) {
+            throw std::invalid_argument("El campo \"" + key + "\" debe ser una lista de cadenas");
+        }
+        out.push_back(value.items[i].text);
+    }
+    return out;
+}
+
+// Distribución como objeto {"clave": p} o como array en el orden de keys
+std::map<std::string, double> distribution(const JsonValue& value, const std::vector<std::string>& keys,
+                                           const std::string& what) {
+    std::map<std::string, double> out;
+    if (value.type == JsonValue::ARRAY) {
+        if (value.items.size() != keys.size()) {
+            throw std::invalid_argument("Número de valores incorrecto en " + what);
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (value.items[i].type != JsonValue::NUMBER) {
+                throw std::invalid_argument("Se esperaba un número en " + what);
+            }
+            out[keys[i]] = value.items[i].number;
+        }
+    } else if (value.type == JsonValue::OBJECT) {
+        for (size_t i = 0; i < value.members.size(); i++) {
+            if (value.members[i].second.type != JsonValue::NUMBER) {
+                throw std::invalid_argument("Se esperaba un número en " + what);
+            }
+            out[value.members[i].first] = value.members[i].second.number;
+        }
+    } else {
+        throw std::invalid_argument("Se esperaba un objeto o un array en " + what);
+    }
+    return out;
+}
+
+// Tabla por estado: objeto {"estado": distribución} o array en el orden de los estados
+std::map<std::string, std::map<std::string, double>> table(const JsonValue& value,
+                                                           const std::vector<std::string>& states,
+                                                           const std::vector<std::string>& keys,
+                                                           const std::string& what) {
+    std::map<std::string, std::map<std::string, double>> out;
+    if (value.type == JsonValue::ARRAY) {
+        if (value.items.size() != states.size()) {
+            throw std::invalid_argument("Número de filas incorrecto en " + what);
+        }
+        for (size_t i = 0; i < states.size(); i++) {
+            out[states[i]] = distribution(value.items[i], keys, what);
+        }
+    } else if (value.type == JsonValue::OBJECT) {
+        for (size_t i = 0; i < value.members.size(); i++) {
+            out[value.members[i].first] = distribution(value.members[i].second, keys, what);
+        }
+    } else {
+        throw std::invalid_argument("Se esperaba un objeto o un array en " + what);
+    }
+    return out;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out + "\"";
+}
+
+std::string jsonNumber(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+}  // namespace
+
+HMM_DNA_Analyzer cargar_modelo_json(const std::string& ruta) {
+    std::string text = readFile(ruta);
+    JsonValue root = JsonParser(text).parse();
+    if (root.type != JsonValue::OBJECT) {
+        throw std::invalid_argument("El modelo JSON debe ser un objeto");
+    }
+
+    std::vector<std::string> states = stringList(member(root, "estados"), "estados");
+    std::vector<std::string> observations = stringList(member(root, "observaciones"), "observaciones");
+    return HMM_DNA_Analyzer(states, observations,
+                            distribution(member(root, "inicio"), states, "las probabilidades iniciales"),
+                            table(member(root, "transiciones"), states, states, "las transiciones"),
+                            table(member(root, "emisiones"), states, observations, "las emisiones"));
+}
+
+HMM_DNA_Analyzer cargar_modelo_tsv(const std::string& ruta) {
+    std::istringstream input(readFile(ruta));
+    std::vector<std::string> states, observations;
+    std::map<std::string, double> start;
+    std::map<std::string, std::map<std::string, double>> trans, emit;
+
+    std::string line;
+    for (int line_number = 1; std::getline(input, line); line_number++) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::vector<std::string> fields;
+        std::istringstream tokens(line);
+        for (std::string field; std::getline(tokens, field, '\t');) {
+            fields.push_back(field);
+        }
+        std::string where = " en la línea " + std::to_string(line_number);
+
+        // Convierte el último campo en probabilidad
+        auto probability = [&]() {
+            char* end;
+            double value = std::strtod(fields.back().c_str(), &end);
+            if (fields.back().empty() || *end != '\0') {
+                throw std::invalid_argument("Probabilidad inválida '" + fields.back() + "'" + where);
+            }
+            return value;
+        };
+
+        const std::string& kind = fields[0];
+        if (kind == "estados" && fields.size() > 1) {
+            states.assign(fields.begin() + 1, fields.end());
+        } else if (kind == "observaciones" && fields.size() > 1) {
+            observations.assign(fields.begin() + 1, fields.end());
+        } else if (kind == "inicio" && fields.size() == 3) {
+            start[fields[1]] = probability();
+        } else if (kind == "transicion" && fields.size() == 4) {
+            trans[fields[1]][fields[2]] = probability();
+        } else if (kind == "emision" && fields.size() == 4) {
+            emit[fields[1]][fields[2]] = probability();
+        } else {
+            throw std::invalid_argument("Entrada no reconocida" + where + ": '" + line + "'");
+        }
+    }
+
+    return HMM_DNA_Analyzer(states, observations, start, trans, emit);
+}
+
+HMM_DNA_Analyzer cargar_modelo(const std::string& ruta) {
+    const std::string extension = ".json";
+    if (ruta.size() >= extension.size() &&
+        ruta.compare(ruta.size() - extension.size(), extension.size(), extension) == 0) {
+        return cargar_modelo_json(ruta);
+    }
+    return cargar_modelo_tsv(ruta);
+}
+
+void guardar_modelo_json(const HMM_DNA_Analyzer& analizador, const std::string& ruta) {
+    std::vector<std::string> states = analizador.getStates();
+    std::vector<std::string> observations = analizador.getObservations();
+    std::map<std::string, double> start = analizador.getStartProbabilities();
+    std::map<std::string, std::map<std::string, double>> trans = analizador.getTransitionProbabilities();
+    std::map<std::string, std::map<std::string, double>> emit = analizador.getEmissionProbabilities();
+
+    std::ostringstream out;
+    out << "{\n  \"estados\": [";
+    for (size_t i = 0; i < states.size(); i++) {
+        out << (i ? ", " : "") << jsonString(states[i]);
+    }
+    out << "],\n  \"observaciones\": [";
+    for (size_t k = 0; k < observations.size(); k++) {
+        out << (k ? ", " : "") << jsonString(observations[k]);
+    }
+    out << "],\n  \"inicio\": {";
+    for (size_t i = 0; i < states.size(); i++) {
+        out << (i ? ", " : "") << jsonString(states[i]) << ": " << jsonNumber(start[states[i]]);
+    }
+    out << "},\n  \"transiciones\": {";
+    for (size_t i = 0; i < states.size(); i++) {
+        out << (i ? "," : "") << "\n    " << jsonString(states[i]) << ": {";
+        for (size_t j = 0; j < states.size(); j++) {
+            out << (j ? ", " : "") << jsonString(states[j]) << ": " << jsonNumber(trans[states[i]][states[j]]);
+        }
+        out << "}";
+    }
+    out << "\n  },\n  \"emisiones\": {";
+    for (size_t i = 0; i < states.size(); i++) {
+        out << (i ? "," : "") << "\n    " << jsonString(states[i]) << ": {";
+        for (size_t k = 0; k < observations.size(); k++) {
+            out << (k ? ", " : "") << jsonString(observations[k]) << ": "
+                << jsonNumber(emit[states[i]][observations[k]]);
+        }
+        out << "}";
+    }
+    out << "\n  }\n}\n";
+
+    std::ofstream file(ruta.c_str(), std::ios::binary);
+    if (!file || !(file << out.str())) {
+        throw std::runtime_error("No se pudo escribir el archivo: " + ruta);
+    }
+}
+
+// Implementaciones de MappedFasta
+RegistroFasta::RegistroFasta() : longitud(0), offset(0), bases_linea(0), bytes_linea(0) {}
+
+MappedFasta::MappedFasta(const std::string& ruta) : path(ruta), data(NULL), num_bytes(0) {
+    int fd = open(ruta.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
+    }
+    num_bytes = info.st_size;
+    if (num_bytes > 0) {
+        void* mapping = mmap(NULL, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("No se pudo proyectar el archivo: " + ruta);
+        }
+        data = static_cast<const char*>(mapping);
+    }
+    close(fd);
+
+    try {
+        std::string index_path = ruta + ".fai";
+        if (stat(index_path.c_str(), &info) == 0) {
+            loadIndex(index_path);
+        } else {
+            buildIndex();
+        }
+    } catch (...) {
+        if (data) munmap(const_cast<char*>(data), num_bytes);
+        throw;
+    }
+}
+
+MappedFasta::~MappedFasta() {
+    if (data) munmap(const_cast<char*>(data), num_bytes);
+}
+
+void MappedFasta::buildIndex() {
+    RegistroFasta* record = NULL;
+    bool closed = false;  // ya hubo una línea más corta: no puede haber más bases
+    size_t line_number = 0;
+
+    for (size_t pos = 0; pos < num_bytes; line_number++) {
+        const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', num_bytes - pos));
+        size_t end = newline ? newline - data : num_bytes;
+        size_t next = newline ? end + 1 : num_bytes;
+        size_t length = end - pos;
+        if (length > 0 && data[end - 1] == '\r') length--;
+        auto fail = [&](const std::string& message) {
+            throw std::invalid_argument("FASTA inválido: " + message + " en la línea " +
+                                        std::to_string(line_number + 1) + " de " + path);
+        };
+
+        if (length > 0 && data[pos] == '>') {
+            size_t name_end = pos + 1;
+            while (name_end < pos + length && data[name_end] != ' ' && data[name_end] != '\t') name_end++;
+            records.push_back(RegistroFasta());
+            record = &records.back();
+            record->nombre.assign(data + pos + 1, name_end - pos - 1);
+            record->offset = next;
+            closed = false;
+        } else if (length > 0) {
+            if (!record) {
+                fail("hay bases antes del primer '>'");
+            }
+            if (closed || (record->bases_linea > 0 && length > record->bases_linea)) {
+                fail("longitudes de línea distintas en el registro " + record->nombre);
+            }
+            if (record->bases_linea == 0) {
+                record->bases_linea = length;
+                record->bytes_linea = next - pos;
+            } else if (length < record->bases_linea) {
+                closed = true;
+            } else if (next - pos != record->bytes_linea && newline) {
+                fail("saltos de línea distintos en el registro " + record->nombre);
+            }
+            record->longitud += length;
+        } else if (record) {
+            closed = true;
+        }
+        pos = next;
+    }
+}
+
+void MappedFasta::loadIndex(const std::string& index_path) {
+    std::istringstream input(readFile(index_path));
+    std::string line;
+    for (int line_number = 1; std::getline(input, line); line_number++) {
+        if (line.empty()) continue;
+        std::vector<std::string> fields;
+        std::istringstream tokens(line);
+        for (std::string field; std::getline(tokens, field, '\t');) {
+            fields.push_back(field);
+        }
+
+        RegistroFasta record;
+        bool valid = fields.size() >= 5;
+        size_t* values[] = {&record.longitud, &record.offset, &record.bases_linea, &record.bytes_linea};
+        for (int f = 0; valid && f < 4; f++) {
+            char* end;
+            *values[f] = std::strtoull(fields[f + 1].c_str(), &end, 10);
+            valid = !fields[f + 1].empty() && *end == '\0';
+        }
+        if (valid) {
+            record.nombre = fields[0];
+            valid = record.longitud == 0 ||
+                    (record.bases_linea > 0 && record.bytes_linea >= record.bases_linea &&
+                     record.offset + (record.longitud - 1) / record.bases_linea * record.bytes_linea +
+                             (record.longitud - 1) % record.bases_linea < num_bytes);
+        }
+        if (!valid) {
+            throw std::invalid_argument("Índice inválido o de otro archivo en la línea " + std::to_string(line_number) +
+                                        " de " + index_path);
+        }
+        records.push_back(record);
+    }
+}
+
+size_t MappedFasta::num_registros() const {
+    return records.size();
+}
+
+RegistroFasta MappedFasta::registro(size_t i) const {
+    if (i >= records.size()) {
+        throw std::out_of_range("Registro fuera de rango: " + std::to_string(i));
+    }
+    return records[i];
+}
+
+size_t MappedFasta::buscar(const std::string& nombre) const {
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].nombre == nombre) return i;
+    }
+    throw std::invalid_argument("No hay ningún registro llamado " + nombre);
+}
+
+PackedSequence MappedFasta::empaquetar(size_t i) const {
+    RegistroFasta record = registro(i);
+    PackedSequence packed;
+    packed.reserve(record.longitud);
+    const char* line = data + record.offset;
+    for (size_t remaining = record.longitud; remaining > 0; line += record.bytes_linea) {
+        size_t count = std::min(remaining, record.bases_linea);
+        packed.append(line, count);
+        remaining -= count;
+    }
+    return packed;
+}
+
+std::string MappedFasta::secuencia(size_t i) const {
+    RegistroFasta record = registro(i);
+    std::string sequence;
+    sequence.reserve(record.longitud);
+    const char* line = data + record.offset;
+    for (size_t remaining = record.longitud; remaining > 0; line += record.bytes_linea) {
+        size_t count = std::min(remaining, record.bases_linea);
+        sequence.append(line, count);
+        remaining -= count;
+    }
+    return sequence;
+}
+
+void MappedFasta::guardar_indice(const std::string& ruta) const {
+    std::ostringstream out;
+    for (size_t i = 0; i < records.size(); i++) {
+        const RegistroFasta& record = records[i];
+        out << record.nombre << '\t' << record.longitud << '\t' << record.offset << '\t' << record.bases_linea
+            << '\t' << record.bytes_linea << '\n';
+    }
+
+    std::ofstream file(ruta.c_str(), std::ios::binary);
+    if (!file || !(file << out.str())) {
+        throw std::runtime_error("No se pudo escribir el archivo: " + ruta);
+    }
+}
+
+// Implementaciones de ReadPipeline
+BloqueLecturas::BloqueLecturas() : primera_lectura(0), offsets(1, 0) {}
+
+size_t BloqueLecturas::size() const {
+    return nombres.size();
+}
+
+ReadPipeline::BlockQueue::BlockQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+bool ReadPipeline::BlockQueue::push(BloqueLecturas& block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return closed || items.size() < capacity; });
+    if (closed) return false;
+    items.push_back(std::move(block));
+    changed.notify_all();
+    return true;
+}
+
+bool ReadPipeline::BlockQueue::pop(BloqueLecturas& block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return closed || !items.empty(); });
+    if (items.empty()) return false;
+    block = std::move(items.front());
+    items.pop_front();
+    changed.notify_all();
+    return true;
+}
+
+void ReadPipeline::BlockQueue::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    changed.notify_all();
+}
+
+ReadPipeline::ReadPipeline(const HMM_DNA_Analyzer& analizador, const std::string& ruta, bool solo_evaluacion,
+                           size_t bases_por_bloque, size_t bloques_en_cola)
+    : analyzer(analizador), path(ruta), evaluation_only(solo_evaluacion), block_bases(bases_por_bloque),
+      parsed(bloques_en_cola), analyzed(bloques_en_cola) {
+    if (bases_por_bloque == 0 || bloques_en_cola == 0) {
+        throw std::invalid_argument("El tamaño de bloque y la capacidad de las colas deben ser al menos 1");
+    }
+    if (!std::ifstream(ruta.c_str())) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
+    }
+    reader = std::thread(&ReadPipeline::readBlocks, this);
+    worker = std::thread(&ReadPipeline::analyzeBlocks, this);
+}
+
+ReadPipeline::~ReadPipeline() {
+    parsed.close();
+    analyzed.close();
+    reader.join();
+    worker.join();
+}
+
+void ReadPipeline::fail() {
+    {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+    }
+    parsed.close();
+    analyzed.close();
+}
+
+namespace {
+
+// Pasa a mayúsculas los símbolos que solo están en mayúscula en el
+// alfabeto; false si la lectura está vacía o sigue teniendo símbolos
+// que el modelo no conoce
+bool normalizeRead(const CompiledModel& model, char* bases, size_t length) {
+    if (length == 0) return false;
+    for (size_t t = 0; t < length; t++) {
+        unsigned char c = bases[t];
+        if (model.symbol_index[c] >= 0) continue;
+        unsigned char upper = std::toupper(c);
+        if (model.symbol_index[upper] < 0) return false;
+        bases[t] = upper;
+    }
+    return true;
+}
+
+// Vuelve a numerar un resultado por lecturas del bloque: rejected (ordenado)
+// no se analizó y ocupa un tramo vacío con NaN en los valores por lectura
+void insertRejected(std::vector<size_t>& offsets, const std::vector<size_t>& rejected) {
+    std::vector<size_t> out;
+    out.reserve(offsets.size() + rejected.size());
+    out.push_back(offsets[0]);
+    size_t k = 0, r = 1;
+    for (size_t read = 0; read + 1 < offsets.size() + rejected.size(); read++) {
+        if (k < rejected.size() && rejected[k] == read) {
+            out.push_back(out.back());
+            k++;
+        } else {
+            out.push_back(offsets[r++]);
+        }
+    }
+    offsets.swap(out);
+}
+
+void insertRejected(std::vector<double>& values, const std::vector<size_t>& rejected) {
+    for (size_t k = 0; k < rejected.size(); k++) {
+        values.insert(values.begin() + rejected[k], std::numeric_limits<double>::quiet_NaN());
+    }
+}
+
+}  // namespace
+
+void ReadPipeline::readBlocks() {
+    try {
+        GzLineReader lines(path);
+        const char* line;
+        size_t length;
+        bool has_line = lines.next(line, length);
+        while (has_line && length == 0) has_line = lines.next(line, length);
+        char marker = has_line ? line[0] : '>';
+        if (marker != '@' && marker != '>') {
+            throw std::invalid_argument("Formato desconocido (se esperaba FASTQ o FASTA): " + path);
+        }
+        auto invalid = [&](const std::string& message) {
+            throw std::invalid_argument(std::string(marker == '@' ? "FASTQ" : "FASTA") + " inválido en la línea " +
+                                        std::to_string(lines.lineNumber()) + " de " + path + ": " + message);
+        };
+
+        BloqueLecturas block;
+        size_t num_reads = 0;
+        while (has_line) {
+            if (length == 0) {
+                has_line = lines.next(line, length);
+                continue;
+            }
+            if (line[0] != marker) invalid(std::string("se esperaba '") + marker + "'");
+            size_t name_end = 1;
+            while (name_end < length && line[name_end] != ' ' && line[name_end] != '\t') name_end++;
+            block.nombres.push_back(std::string(line + 1, name_end - 1));
+
+            if (marker == '@') {
+                if (!lines.next(line, length)) invalid("faltan las bases");
+                size_t read_length = length;
+                block.bases.append(line, length);
+                if (!lines.next(line, length) || length == 0 || line[0] != '+') invalid("se esperaba '+'");
+                if (!lines.next(line, length) || length != read_length) {
+                    invalid("la calidad no tiene la misma longitud que las bases");
+                }
+                has_line = lines.next(line, length);
+            } else {
+                while ((has_line = lines.next(line, length)) && (length == 0 || line[0] != '>')) {
+                    block.bases.append(line, length);
+                }
+            }
+            size_t start = block.offsets.back();
+            if (!normalizeRead(analyzer.getCompiledModel(), &block.bases[0] + start, block.bases.size() - start)) {
+                block.rechazadas.push_back(block.size() - 1);
+            }
+            block.offsets.push_back(block.bases.size());
+            num_reads++;
+
+            if (block.bases.size() >= block_bases) {
+                if (!parsed.push(block)) return;
+                block = BloqueLecturas();
+                block.primera_lectura = num_reads;
+            }
+        }
+        if (block.size() > 0 && !parsed.push(block)) return;
+        parsed.close();
+    } catch (...) {
+        fail();
+    }
+}
+
+void ReadPipeline::analyzeBlocks() {
+    try {
+        BloqueLecturas block;
+        while (parsed.pop(block)) {
+            try {
+                // Solo se analizan las lecturas válidas, juntas si hay rechazadas
+                const std::vector<size_t>& rejected = block.rechazadas;
+                std::string compacted;
+                std::vector<size_t> compacted_offsets(1, 0);
+                if (!rejected.empty()) {
+                    compacted.reserve(block.bases.size());
+                    for (size_t r = 0, k = 0; r < block.size(); r++) {
+                        if (k < rejected.size() && rejected[k] == r) {
+                            k++;
+                            continue;
+                        }
+                        compacted.append(block.bases, block.offsets[r], block.offsets[r + 1] - block.offsets[r]);
+                        compacted_offsets.push_back(compacted.size());
+                    }
+                }
+                const std::string& bases = rejected.empty() ? block.bases : compacted;
+                const std::vector<size_t>& offsets = rejected.empty() ? block.offsets : compacted_offsets;
+
+                if (evaluation_only) {
+                    block.log_verosimilitudes =
+                        offsets.size() > 1 ? analyzer.evaluacion_log_batch(bases, offsets) : std::vector<double>();
+                    insertRejected(block.log_verosimilitudes, rejected);
+                } else {
+                    AnalisisBatchResult& analisis = block.analisis;
+                    if (offsets.size() > 1) {
+                        analisis = analyzer.analizar_regiones_batch(bases, offsets);
+                    } else {
+                        analisis = AnalisisBatchResult();
+                        analisis.nombres_estados = analyzer.getStates();
+                        analisis.offsets.assign(1, 0);
+                        analisis.region_offsets.assign(1, 0);
+                    }
+                    insertRejected(analisis.offsets, rejected);
+                    insertRejected(analisis.region_offsets, rejected);
+                    insertRejected(analisis.log_probabilidades, rejected);
+                    insertRejected(analisis.probabilidades_totales, rejected);
+                }
+            } catch (const std::invalid_argument& e) {
+                // Los métodos batch numeran las lecturas dentro del bloque
+                throw std::invalid_argument(std::string(e.what()) + " (bloque desde la lectura " +
+                                            std::to_string(block.primera_lectura) + " de " + path + ")");
+            }
+            if (!analyzed.push(block)) return;
+        }
+        analyzed.close();
+    } catch (...) {
+        fail();
+    }
+}
+
+bool ReadPipeline::siguiente(BloqueLecturas& bloque) {
+    if (analyzed.pop(bloque)) return true;
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (error) std::rethrow_exception(error);
+    return false;
+}
+
+// Implementaciones de RegionWriter
+RegionWriter::RegionWriter(const std::string& ruta, const std::string& formato)
+    : file(NULL), path(ruta), gff3(false), num_regions(0) {
+    std::string format = formato;
+    if (format.empty()) {
+        size_t dot = ruta.rfind('.');
+        std::string extension = dot == std::string::npos ? "" : ruta.substr(dot);
+        format = (extension == ".gff" || extension == ".gff3") ? "gff3" : "bed";
+    }
+    if (format != "bed" && format != "gff3") {
+        throw std::invalid_argument("Formato de regiones desconocido '" + formato + "': debe ser bed o gff3");
+    }
+    gff3 = format == "gff3";
+
+    file = std::fopen(ruta.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
+    }
+    buffer.reserve(WRITE_BLOCK + 4096);
+    if (gff3) buffer += "##gff-version 3\n";
+}
+
+RegionWriter::~RegionWriter() {
+    try {
+        cerrar();
+    } catch (...) {
+    }
+}
+
+void RegionWriter::flush() {
+    if (buffer.empty()) return;
+    if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        throw std::runtime_error("No se pudo escribir el archivo: " + path);
+    }
+    buffer.clear();
+}
+
+void RegionWriter::cerrar() {
+    if (!file) return;
+    std::FILE* closing = file;
+    file = NULL;
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), closing) == buffer.size();
+    buffer.clear();
+    if (std::fclose(closing) != 0 || !ok) {
+        throw std::runtime_error("No se pudo escribir el archivo: " + path);
+    }
+}
+
+std::string RegionWriter::column(const std::string& text, bool name) const {
+    if (gff3) return gffEscape(text, name);
+    // En BED los espacios, tabuladores o saltos de línea desplazarían las columnas
+    std::string out = text;
+    for (size_t i = 0; i < out.size(); i++) {
+        if (std::isspace((unsigned char)out[i])) out[i] = '_';
+    }
+    return out;
+}
+
+std::vector<std::string> RegionWriter::stateColumns(const std::vector<std::string>& names) const {
+    std::vector<std::string> columns(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        columns[i] = column(names[i], true);
+    }
+    return columns;
+}
+
+void RegionWriter::writeRegion(const std::string& chromosome, size_t start, size_t end, const std::string& name,
+                               const double* probs, char strand) {
+    if (!file) {
+        throw std::runtime_error("El archivo de regiones ya está cerrado: " + path);
+    }
+
+    // Puntuación: media de la puntuación por posición, con 4 decimales (x 1000 en BED)
+    size_t score = 0;
+    if (probs) {
+        double sum = 0.0;
+        for (size_t t = 0; t < end - start; t++) sum += probs[t];
+        score = std::lround(sum / (end - start) * (gff3 ? 10000.0 : 1000.0));
+    }
+
+    buffer += chromosome;
+    if (gff3) {
+        buffer += "\tHMMmethods\tregion\t";
+        appendNumber(buffer, start + 1);
+        buffer += '\t';
+        appendNumber(buffer, end);
+        buffer += '\t';
+        if (probs) {
+            appendNumber(buffer, score / 10000);
+            buffer += '.';
+            for (size_t unit = 1000; unit > 0; unit /= 10) {
+                buffer += '0' + score / unit % 10;
+            }
+        } else {
+            buffer += '.';
+        }
+        buffer += '\t';
+        buffer += strand;
+        buffer += "\t.\tID=region";
+        appendNumber(buffer, ++num_regions);
+        buffer += ";Name=";
+        buffer += name;
+    } else {
+        buffer += '\t';
+        appendNumber(buffer, start);
+        buffer += '\t';
+        appendNumber(buffer, end);
+        buffer += '\t';
+        buffer += name;
+        buffer += '\t';
+        appendNumber(buffer, score);
+        buffer += '\t';
+        buffer += strand;
+    }
+    buffer += '\n';
+
+    if (buffer.size() >= WRITE_BLOCK) flush();
+}
+
+void RegionWriter::escribir(const std::string& cromosoma, const PosteriorResult& posterior, size_t desplazamiento,
+                            char hebra) {
+    checkStrand(hebra);
+    const std::vector<unsigned char>& codes = posterior.codigos;
+    if (posterior.probabilidades.size() != codes.size()) {
+        throw std::invalid_argument("Estados y probabilidades de distinta longitud en " + cromosoma);
+    }
+    std::string chromosome = column(cromosoma, false);
+    std::vector<std::string> names = stateColumns(posterior.nombres_estados);
+    for (size_t start = 0, end; start < codes.size(); start = end) {
+        for (end = start + 1; end < codes.size() && codes[end] == codes[start]; end++) {
+        }
+        if (codes[start] >= names.size()) {
+            throw std::invalid_argument("Código de estado fuera de rango en " + cromosoma);
+        }
+        writeRegion(chromosome, desplazamiento + start, desplazamiento + end, names[codes[start]],
+                    &posterior.probabilidades[start], hebra);
+    }
+}
+
+void RegionWriter::escribir(const std::string& cromosoma, const AnalysisResult& analisis, size_t desplazamiento,
+                            char hebra) {
+    checkStrand(hebra);
+    // Las dos listas están ordenadas: se mezclan en orden de posición
+    std::string chromosome = column(cromosoma, false);
+    const std::vector<Region>& coding = analisis.regiones_codificantes;
+    const std::vector<Region>& non_coding = analisis.regiones_no_codificantes;
+    size_t c = 0, k = 0;
+    while (c < coding.size() || k < non_coding.size()) {
+        bool take_coding = k == non_coding.size() || (c < coding.size() && coding[c].inicio < non_coding[k].inicio);
+        const Region& region = take_coding ? coding[c++] : non_coding[k++];
+        writeRegion(chromosome, desplazamiento + region.inicio, desplazamiento + region.fin + 1,
+                    column(analisis.estados_predichos[region.inicio], true),
+                    &analisis.probabilidades_posicion[region.inicio], hebra);
+    }
+}
+
+void RegionWriter::escribir(const std::string& cromosoma, const AnalisisCompacto& analisis, size_t desplazamiento,
+                            char hebra) {
+    checkStrand(hebra);
+    std::string chromosome = column(cromosoma, false);
+    std::vector<std::string> names = stateColumns(analisis.nombres_estados);
+    for (size_t i = 0; i < analisis.regiones.size(); i++) {
+        const RegionCompacta& region = analisis.regiones[i];
+        writeRegion(chromosome, desplazamiento + region.inicio, desplazamiento + region.fin + 1, names[region.estado],
+                    &analisis.probabilidades[region.inicio], hebra);
+    }
+}
+
+void RegionWriter::escribir(const std::string& cromosoma, const std::vector<Region>& regiones, size_t desplazamiento,
+                            char hebra) {
+    checkStrand(hebra);
+    std::string chromosome = column(cromosoma, false);
+    for (size_t i = 0; i < regiones.size(); i++) {
+        const Region& region = regiones[i];
+        writeRegion(chromosome, desplazamiento + region.inicio, desplazamiento + region.fin + 1,
+                    column(region.tipo, true), NULL, hebra);
+    }
+}
+
+void RegionWriter::escribir(const BloqueLecturas& bloque, char hebra) {
+    checkStrand(hebra);
+    const AnalisisBatchResult& analisis = bloque.analisis;
+    if (analisis.region_offsets.size() != bloque.size() + 1) {
+        throw std::invalid_argument("El bloque no tiene regiones (se leyó con solo_evaluacion)");
+    }
+    std::vector<std::string> names = stateColumns(analisis.nombres_estados);
+    for (size_t r = 0; r < bloque.size(); r++) {
+        std::string chromosome = column(bloque.nombres[r], false);
+        const double* probs = &analisis.probabilidades[0] + analisis.offsets[r];
+        for (size_t k = analisis.region_offsets[r]; k < analisis.region_offsets[r + 1]; k++) {
+            writeRegion(chromosome, analisis.region_inicio[k], analisis.region_fin[k] + 1,
+                        names[analisis.region_estado[k]], probs + analisis.region_inicio[k], hebra);
+        }
+    }
+}
+
+uint64_t huella_modelo(const HMM_DNA_Analyzer& analizador) {
+    const CompiledModel& model = analizador.getCompiledModel();
+    uint64_t hash = 14695981039346656037ULL;
+    hash = fnv1a(hash, analizador.getStates());
+    hash = fnv1a(hash, analizador.getObservations());
+    hash = fnv1a(hash, model.start);
+    hash = fnv1a(hash, model.trans);
+    return fnv1a(hash, model.emit);
+}
+
+// Implementaciones de ResultWriter
+ResultWriter::ResultWriter(const std::string& ruta, const HMM_DNA_Analyzer& analizador)
+    : file(NULL), path(ruta), state_names(analizador.getStates()), fingerprint(huella_modelo(analizador)),
+      offset(0) {
+    file = std::fopen(ruta.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
+    }
+    try {
+        // La cabecera se reescribe al cerrar con el número de registros y el índice
+        ResultHeader header = ResultHeader();
+        write(&header, sizeof(header));
+        for (size_t i = 0; i < state_names.size(); i++) {
+            uint64_t length = state_names[i].size();
+            write(&length, sizeof(length));
+            write(state_names[i].data(), state_names[i].size());
+            align();
+        }
+    } catch (...) {
+        std::fclose(file);
+        file = NULL;
+        throw;
+    }
+}
+
+ResultWriter::~ResultWriter() {
+    try {
+        cerrar();
+    } catch (...) {
+    }
+}
+
+void ResultWriter::write(const void* bytes, size_t size) {
+    if (size > 0 && std::fwrite(bytes, 1, size, file) != size) {
+        throw std::runtime_error("No se pudo escribir el archivo: " + path);
+    }
+    offset += size;
+}
+
+void ResultWriter::align() {
+    static const char zeros[8] = {0};
+    write(zeros, aligned(offset) - offset);
+}
+
+void ResultWriter::checkStates(const std::vector<std::string>& names) const {
+    if (names != state_names) {
+        throw std::invalid_argument("El resultado no tiene los estados del modelo del archivo: " + path);
+    }
+}
+
+void ResultWriter::writeRecord(const std::string& name, const unsigned char* codes, const double* probs, size_t n) {
+    if (!file) {
+        throw std::runtime_error("El archivo de resultados ya está cerrado: " + path);
+    }
+
+    // Tramos de estado constante, su probabilidad media y el bitmap de sus inicios
+    std::vector<uint64_t> starts;
+    std::vector<float> means;
+    std::vector<unsigned char> states;
+    std::vector<uint64_t> rank((n + RANK_BLOCK - 1) / RANK_BLOCK * RANK_WORDS, 0);
+    double sum = 0.0;
+    for (size_t t = 0; t < n; t++) {
+        if (codes[t] >= state_names.size()) {
+            throw std::invalid_argument("Código de estado fuera de rango en el registro " + name);
+        }
+        if (t == 0 || codes[t] != codes[t - 1]) {
+            if (t > 0) means.push_back((float)(sum / (t - starts.back())));
+            starts.push_back(t);
+            states.push_back(codes[t]);
+            rank[t / RANK_BLOCK * RANK_WORDS + 1 + t % RANK_BLOCK / 64] |= uint64_t(1) << (t % 64);
+            sum = 0.0;
+        }
+        sum += probs[t];
+    }
+    if (n > 0) means.push_back((float)(sum / (n - starts.back())));
+    starts.push_back(n);
+
+    uint64_t before = 0;
+    for (size_t block = 0; block < rank.size(); block += RANK_WORDS) {
+        rank[block] = before;
+        for (size_t w = 1; w < RANK_WORDS; w++) before += __builtin_popcountll(rank[block + w]);
+    }
+
+    uint64_t entry[RESULT_ENTRY_WORDS] = {name_pool.size(), name.size(), n, states.size(), 0, 0, 0};
+    entry[4] = offset;
+    write(starts.data(), starts.size() * sizeof(uint64_t));
+    write(means.data(), means.size() * sizeof(float));
+    align();
+    write(states.data(), states.size());
+    align();
+    entry[5] = offset;
+    write(rank.data(), rank.size() * sizeof(uint64_t));
+    entry[6] = offset;
+
+    // Probabilidades cuantizadas a 8 bits, por trozos
+    unsigned char chunk[1 << 16];
+    for (size_t t = 0; t < n; t += sizeof(chunk)) {
+        size_t count = std::min(n - t, sizeof(chunk));
+        for (size_t k = 0; k < count; k++) {
+            double p = std::min(std::max(probs[t + k], 0.0), 1.0);
+            chunk[k] = (unsigned char)(p * 255.0 + 0.5);
+        }
+        write(chunk, count);
+    }
+    align();
+
+    entries.insert(entries.end(), entry, entry + RESULT_ENTRY_WORDS);
+    name_pool += name;
+}
+
+void ResultWriter::escribir(const std::string& nombre, const AnalysisResult& analisis) {
+    size_t n = analisis.estados_predichos.size();
+    if (analisis.probabilidades_posicion.size() != n) {
+        throw std::invalid_argument("Estados y probabilidades de distinta longitud en el registro " + nombre);
+    }
+    std::map<std::string, unsigned char> index;
+    for (size_t i = 0; i < state_names.size(); i++) index[state_names[i]] = (unsigned char)i;
+    std::vector<unsigned char> codes(n);
+    for (size_t t = 0; t < n; t++) {
+        std::map<std::string, unsigned char>::const_iterator it = index.find(analisis.estados_predichos[t]);
+        if (it == index.end()) {
+            throw std::invalid_argument("Estado desconocido '" + analisis.estados_predichos[t] + "' en el registro " +
+                                        nombre);
+        }
+        codes[t] = it->second;
+    }
+    writeRecord(nombre, codes.data(), analisis.probabilidades_posicion.data(), n);
+}
+
+void ResultWriter::escribir(const std::string& nombre, const AnalisisCompacto& analisis) {
+    checkStates(analisis.nombres_estados);
+    if (analisis.probabilidades.size() != analisis.codigos.size()) {
+        throw std::invalid_argument("Estados y probabilidades de distinta longitud en el registro " + nombre);
+    }
+    writeRecord(nombre, analisis.codigos.data(), analisis.probabilidades.data(), analisis.codigos.size());
+}
+
+void ResultWriter::escribir(const std::string& nombre, const PosteriorResult& posterior) {
+    checkStates(posterior.nombres_estados);
+    if (posterior.probabilidades.size() != posterior.codigos.size()) {
+        throw std::invalid_argument("Estados y probabilidades de distinta longitud en el registro " + nombre);
+    }
+    writeRecord(nombre, posterior.codigos.data(), posterior.probabilidades.data(), posterior.codigos.size());
+}
+
+void ResultWriter::escribir(const BloqueLecturas& bloque) {
+    const AnalisisBatchResult& analisis = bloque.analisis;
+    if (analisis.offsets.size() != bloque.size() + 1) {
+        throw std::invalid_argument("El bloque no tiene análisis (se leyó con solo_evaluacion)");
+    }
+    checkStates(analisis.nombres_estados);
+    for (size_t r = 0, k = 0; r < bloque.size(); r++) {
+        if (k < bloque.rechazadas.size() && bloque.rechazadas[k] == r) {
+            k++;
+            continue;
+        }
+        size_t start = analisis.offsets[r];
+        writeRecord(bloque.nombres[r], analisis.estados.data() + start, analisis.probabilidades.data() + start,
+                    analisis.offsets[r + 1] - start);
+    }
+}
+
+void ResultWriter::cerrar() {
+    if (!file) return;
+    std::FILE* closing = file;
+    bool ok = true;
+    try {
+        ResultHeader header;
+        std::memcpy(header.magic, RESULT_MAGIC, sizeof(header.magic));
+        header.version = RESULT_VERSION;
+        header.num_states = state_names.size();
+        header.fingerprint = fingerprint;
+        header.num_records = entries.size() / RESULT_ENTRY_WORDS;
+        header.index_offset = offset;
+        write(entries.data(), entries.size() * sizeof(uint64_t));
+        write(name_pool.data(), name_pool.size());
+        ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    } catch (...) {
+        ok = false;
+    }
+    file = NULL;
+    if (std::fclose(closing) != 0 || !ok) {
+        throw std::runtime_error("No se pudo escribir el archivo: " + path);
+    }
+}
+
+// Implementaciones de MappedResults
+MappedResults::MappedResults(const std::string& ruta) : path(ruta), data(NULL), num_bytes(0), fingerprint(0) {
+    int fd = open(ruta.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
+    }
+    num_bytes = info.st_size;
+    if (num_bytes > 0) {
+        void* mapping = mmap(NULL, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("No se pudo proyectar el archivo: " + ruta);
+        }
+        data = static_cast<const char*>(mapping);
+    }
+    close(fd);
+
+    try {
+        parse();
+    } catch (...) {
+        if (data) munmap(const_cast<char*>(data), num_bytes);
+        throw;
+    }
+}
+
+MappedResults::~MappedResults() {
+    if (data) munmap(const_cast<char*>(data), num_bytes);
+}
+
+void MappedResults::parse() {
+    const std::string invalid = "Archivo de resultados inválido o truncado: " + path;
+    // Comprueba que [start, start + size) está dentro del archivo
+    auto section = [&](uint64_t start, uint64_t size) {
+        if (start > num_bytes || size > num_bytes - start) throw std::runtime_error(invalid);
+        return data + start;
+    };
+
+    ResultHeader header;
+    std::memcpy(&header, section(0, sizeof(header)), sizeof(header));
+    if (std::memcmp(header.magic, RESULT_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("No es un archivo de resultados: " + path);
+    }
+    if (header.version != RESULT_VERSION) {
+        throw std::runtime_error("Versión de archivo de resultados no soportada: " + path);
+    }
+    if (header.index_offset == 0 || (header.index_offset & 7) != 0) throw std::runtime_error(invalid);
+    fingerprint = header.fingerprint;
+
+    uint64_t pos = sizeof(header);
+    for (uint32_t i = 0; i < header.num_states; i++) {
+        uint64_t length;
+        std::memcpy(&length, section(pos, sizeof(length)), sizeof(length));
+        const char* name = section(pos + sizeof(length), length);
+        state_names.push_back(std::string(name, length));
+        pos = aligned(pos + sizeof(length) + length);
+    }
+
+    if (header.num_records > num_bytes / (RESULT_ENTRY_WORDS * sizeof(uint64_t))) throw std::runtime_error(invalid);
+    uint64_t index_size = header.num_records * RESULT_ENTRY_WORDS * sizeof(uint64_t);
+    const uint64_t* entries = reinterpret_cast<const uint64_t*>(section(header.index_offset, index_size));
+    uint64_t pool = header.index_offset + index_size;
+
+    records.resize(header.num_records);
+    names.reserve(header.num_records);
+    for (size_t i = 0; i < records.size(); i++) {
+        const uint64_t* entry = entries + i * RESULT_ENTRY_WORDS;
+        Record& record = records[i];
+        if (entry[0] > num_bytes || entry[1] > num_bytes || entry[2] > num_bytes || entry[3] > entry[2]) {
+            throw std::runtime_error(invalid);
+        }
+        record.name.assign(section(pool + entry[0], entry[1]), entry[1]);
+        record.length = entry[2];
+        record.num_runs = entry[3];
+
+        uint64_t starts_size = (record.num_runs + 1) * sizeof(uint64_t);
+        uint64_t means_size = record.num_runs * sizeof(float);
+        record.starts = reinterpret_cast<const uint64_t*>(section(entry[4], starts_size));
+        record.means = reinterpret_cast<const float*>(section(entry[4] + starts_size, means_size));
+        record.states = reinterpret_cast<const unsigned char*>(
+            section(entry[4] + aligned(starts_size + means_size), record.num_runs));
+        uint64_t rank_size = (record.length + RANK_BLOCK - 1) / RANK_BLOCK * RANK_WORDS * sizeof(uint64_t);
+        record.rank = reinterpret_cast<const uint64_t*>(section(entry[5], rank_size));
+        record.probs = reinterpret_cast<const unsigned char*>(section(entry[6], record.length));
+        if (((entry[4] | entry[5]) & 7) != 0 || record.starts[record.num_runs] != record.length) {
+            throw std::runtime_error(invalid);
+        }
+        names.insert(std::make_pair(record.name, i));
+    }
+}
+
+const MappedResults::Record& MappedResults::record(size_t i) const {
+    if (i >= records.size()) {
+        throw std::out_of_range("Registro fuera de rango: " + std::to_string(i));
+    }
+    return records[i];
+}
+
+size_t MappedResults::runAt(const Record& record, size_t position) const {
+    if (position >= record.length) {
+        throw std::out_of_range("Posición fuera de rango: " + std::to_string(position));
+    }
+    // Tramos que empiezan en [0, position], menos uno
+    const uint64_t* block = record.rank + position / RANK_BLOCK * RANK_WORDS;
+    size_t word = position % RANK_BLOCK / 64;
+    if (block[0] >= record.num_runs) {
+        throw std::runtime_error("Archivo de resultados inválido o truncado: " + path);
+    }
+    size_t count = block[0];
+    for (size_t w = 0; w < word; w++) count += __builtin_popcountll(block[1 + w]);
+    uint64_t mask = (uint64_t(2) << (position % 64)) - 1;  // bits 0..position % 64
+    count += __builtin_popcountll(block[1 + word] & mask);
+    if (count == 0) {
+        throw std::runtime_error("Archivo de resultados inválido o truncado: " + path);
+    }
+    size_t run = count - 1;
+    checkRun(record, run);
+    // El índice de rango debe estar de acuerdo con los inicios de los tramos
+    if (record.starts[run] > position || record.starts[run + 1] <= position) {
+        throw std::runtime_error("Archivo de resultados inválido o truncado: " + path);
+    }
+    return run;
+}
+
+// Tramo dentro de la tabla, no vacío, dentro del registro y con un estado válido
+void MappedResults::checkRun(const Record& record, size_t run) const {
+    if (run >= record.num_runs || record.starts[run] >= record.starts[run + 1] ||
+        record.starts[run + 1] > record.length || record.states[run] >= state_names.size()) {
+        throw std::runtime_error("Archivo de resultados inválido o truncado: " + path);
+    }
+}
+
+size_t MappedResults::num_registros() const {
+    return records.size();
+}
+
+std::string MappedResults::nombre(size_t i) const {
+    return record(i).name;
+}
+
+size_t MappedResults::longitud(size_t i) const {
+    return record(i).length;
+}
+
+size_t MappedResults::buscar(const std::string& nombre) const {
+    std::unordered_map<std::string, size_t>::const_iterator it = names.find(nombre);
+    if (it == names.end()) {
+        throw std::invalid_argument("No hay ningún registro llamado " + nombre);
+    }
+    return it->second;
+}
+
+std::vector<std::string> MappedResults::nombres_estados() const {
+    return state_names;
+}
+
+uint64_t MappedResults::huella_modelo() const {
+    return fingerprint;
+}
+
+bool MappedResults::compatible(const HMM_DNA_Analyzer& analizador) const {
+    return ::huella_modelo(analizador) == fingerprint;
+}
+
+unsigned char MappedResults::estado(size_t i, size_t posicion) const {
+    const Record& r = record(i);
+    return r.states[runAt(r, posicion)];
+}
+
+double MappedResults::probabilidad(size_t i, size_t posicion) const {
+    const Record& r = record(i);
+    if (posicion >= r.length) {
+        throw std::out_of_range("Posición fuera de rango: " + std::to_string(posicion));
+    }
+    return r.probs[posicion] / 255.0;
+}
+
+std::vector<unsigned char> MappedResults::codigos(size_t i, size_t inicio, size_t fin) const {
+    const Record& r = record(i);
+    if (inicio > fin || fin > r.length) {
+        throw std::out_of_range("Intervalo fuera de rango en el registro " + r.name);
+    }
+    std::vector<unsigned char> codes;
+    codes.reserve(fin - inicio);
+    for (size_t run = inicio < fin ? runAt(r, inicio) : 0; codes.size() < fin - inicio; run++) {
+        checkRun(r, run);
+        size_t end = std::min<uint64_t>(r.starts[run + 1], fin);
+        codes.insert(codes.end(), end - inicio - codes.size(), r.states[run]);
+    }
+    return codes;
+}
+
+size_t MappedResults::num_regiones(size_t i) const {
+    return record(i).num_runs;
+}
+
+RegionCompacta MappedResults::region(size_t i, size_t k) const {
+    const Record& r = record(i);
+    if (k >= r.num_runs) {
+        throw std::out_of_range("Región fuera de rango: " + std::to_string(k));
+    }
+    checkRun(r, k);
+    return RegionCompacta(r.starts[k], r.starts[k + 1] - 1, r.states[k]);
+}
+
+size_t MappedResults::region_en(size_t i, size_t posicion) const {
+    const Record& r = record(i);
+    return runAt(r, posicion);
+}
+
+double MappedResults::probabilidad_media(size_t i, size_t k) const {
+    const Record& r = record(i);
+    if (k >= r.num_runs) {
+        throw std::out_of_range("Región fuera de rango: " + std::to_string(k));
+    }
+    return r.means[k];
+}
+
+std::vector<RegionCompacta> MappedResults::regiones(size_t i, size_t inicio, size_t fin) const {
+    const Record& r = record(i);
+    if (inicio > fin || fin > r.length) {
+        throw std::out_of_range("Intervalo fuera de rango en el registro " + r.name);
+    }
+    std::vector<RegionCompacta> out;
+    if (inicio == fin) return out;
+    for (size_t k = runAt(r, inicio), last = runAt(r, fin - 1); k <= last; k++) {
+        out.push_back(region(i, k));
+    }
+    return out;
+}
@@ -0,0 +1,478 @@
+#ifndef HMM_IO_H
+#define HMM_IO_H
+
+#include "HMMmethods.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Carga un modelo desde un archivo JSON
+ *
+ * Formato:
+ * {
+ *   "estados": ["H", "L"],
+ *   "observaciones": ["A", "C", "G", "T"],
+ *   "inicio": {"H": 0.5, "L": 0.5},
+ *   "transiciones": {"H": {"H": 0.5, "L": 0.5}, "L": {"H": 0.4, "L": 0.6}},
+ *   "emisiones": {"H": {"A": 0.2, "C": 0.3, "G": 0.3, "T": 0.2}, ...}
+ * }
+ * inicio, cada fila de transiciones y cada fila de emisiones también
+ * pueden ser arrays de números en el orden de estados / observaciones.
+ */
+HMM_DNA_Analyzer cargar_modelo_json(const std::string& ruta);
+
+/**
+ * @brief Carga un modelo desde un archivo de texto separado por tabuladores
+ *
+ * Una entrada por línea; las líneas vacías y las que empiezan por # se
+ * ignoran:
+ *   estados        H  L
+ *   observaciones  A  C  G  T
+ *   inicio         H  0.5
+ *   transicion     H  L  0.5
+ *   emision        H  A  0.2
+ */
+HMM_DNA_Analyzer cargar_modelo_tsv(const std::string& ruta);
+
+/**
+ * @brief cargar_modelo_json si la ruta termina en .json, si no cargar_modelo_tsv
+ */
+HMM_DNA_Analyzer cargar_modelo(const std::string& ruta);
+
+/**
+ * @brief Guarda los parámetros del analizador en el formato de cargar_modelo_json
+ *
+ * Los valores se escriben con 17 cifras significativas, de modo que un
+ * modelo entrenado se recupera exactamente.
+ */
+void guardar_modelo_json(const HMM_DNA_Analyzer& analizador, const std::string& ruta);
+
+/**
+ * @brief Entrada de un índice .fai (formato de samtools faidx)
+ */
+struct RegistroFasta {
+    std::string nombre;
+    size_t longitud;     // bases, sin saltos de línea
+    size_t offset;       // byte de la primera base en el archivo
+    size_t bases_linea;  // bases por línea (la última puede tener menos)
+    size_t bytes_linea;  // bytes por línea, con el salto de línea
+
+    RegistroFasta();
+};
+
+/**
+ * @brief Archivo FASTA / multi-FASTA proyectado en memoria
+ *
+ * El archivo se proyecta con mmap y no se copia: los registros se
+ * localizan con un índice .fai (se lee de ruta + ".fai" si existe; si no,
+ * se construye recorriendo el archivo una vez) y empaquetar() convierte
+ * un registro en PackedSequence leyendo sus líneas directamente de la
+ * proyección, a 2 bits por base, para pasarlo a cualquier método del
+ * analizador. La memoria es la de la secuencia empaquetada del registro
+ * en uso más las páginas del archivo que el sistema mantenga en caché.
+ *
+ * Como en samtools faidx, todas las líneas de un registro salvo la
+ * última deben tener la misma longitud; si no, lanza std::invalid_argument.
+ * El nombre de un registro es el texto tras '>' hasta el primer espacio.
+ */
+class MappedFasta {
+private:
+    std::string path;
+    const char* data;
+    size_t num_bytes;
+    std::vector<RegistroFasta> records;
+
+    void buildIndex();
+    void loadIndex(const std::string& index_path);
+
+public:
+    explicit MappedFasta(const std::string& ruta);
+    ~MappedFasta();
+
+    MappedFasta(const MappedFasta&) = delete;
+    MappedFasta& operator=(const MappedFasta&) = delete;
+
+    size_t num_registros() const;
+    RegistroFasta registro(size_t i) const;
+
+    /**
+     * @brief Posición del registro con ese nombre (std::invalid_argument si no existe)
+     */
+    size_t buscar(const std::string& nombre) const;
+
+    /**
+     * @brief Bases del registro i empaquetadas, sin saltos de línea
+     */
+    PackedSequence empaquetar(size_t i) const;
+
+    /**
+     * @brief Bases del registro i como texto (copia), sin saltos de línea
+     */
+    std::string secuencia(size_t i) const;
+
+    /**
+     * @brief Escribe el índice en formato .fai (normalmente en ruta + ".fai")
+     */
+    void guardar_indice(const std::string& ruta) const;
+};
+
+/**
+ * @brief Bloque de lecturas de ReadPipeline con su análisis
+ *
+ * Las bases de la lectura r (la primera_lectura + r del archivo) ocupan
+ * [offsets[r], offsets[r + 1]) en bases; nombres[r] es su nombre, sin '@'
+ * ni '>' y hasta el primer espacio. Con solo_evaluacion, analisis queda
+ * vacío y log_verosimilitudes guarda log P de cada lectura; si no,
+ * analisis es el resultado de analizar_regiones_batch().
+ *
+ * rechazadas son los índices (en el bloque, ordenados) de las lecturas
+ * vacías o con símbolos fuera del alfabeto del modelo (p. ej. N): no se
+ * analizan, su log-verosimilitud y su log P son NaN y no tienen estados
+ * ni regiones. Por eso analisis.offsets indexa analisis.estados y no
+ * bases.
+ */
+struct BloqueLecturas {
+    size_t primera_lectura;
+    std::vector<std::string> nombres;
+    std::string bases;
+    std::vector<size_t> offsets;
+    std::vector<size_t> rechazadas;
+    std::vector<double> log_verosimilitudes;
+    AnalisisBatchResult analisis;
+
+    BloqueLecturas();
+    size_t size() const;
+};
+
+/**
+ * @brief Lectura y análisis en paralelo de un archivo FASTQ o FASTA,
+ * comprimido con gzip o sin comprimir
+ *
+ * Un hilo descomprime y parsea el archivo en bloques de unas
+ * bases_por_bloque bases, y otro los analiza con los métodos batch del
+ * analizador (que a su vez usan getNumThreads() hilos) mientras se lee el
+ * siguiente. Las colas entre las etapas admiten bloques_en_cola bloques:
+ * si el análisis no da abasto la lectura se detiene, y si quien llama a
+ * siguiente() no recoge los bloques se detienen ambas, así que la memoria
+ * está acotada. El rendimiento lo marca la etapa más lenta, no la suma.
+ *
+ * El formato se deduce del primer carácter ('@' FASTQ, '>' FASTA). En
+ * FASTQ cada lectura ocupa 4 líneas; en FASTA las bases pueden ocupar
+ * varias líneas. Las bases en minúscula que el alfabeto solo tiene en
+ * mayúscula (regiones enmascaradas) se leen como mayúsculas; una lectura
+ * que sigue sin ser válida se marca en BloqueLecturas::rechazadas en vez
+ * de detener el archivo. El analizador se copia, así que puede
+ * modificarse o destruirse después de crear el pipeline.
+ */
+class ReadPipeline {
+private:
+    // Cola acotada entre dos etapas; close() despierta a todos los que esperan
+    class BlockQueue {
+    private:
+        std::deque<BloqueLecturas> items;
+        size_t capacity;
+        bool closed;
+        std::mutex mutex;
+        std::condition_variable changed;
+
+    public:
+        explicit BlockQueue(size_t capacity);
+        bool push(BloqueLecturas& block);
+        bool pop(BloqueLecturas& block);
+        void close();
+    };
+
+    HMM_DNA_Analyzer analyzer;
+    std::string path;
+    bool evaluation_only;
+    size_t block_bases;
+    BlockQueue parsed;
+    BlockQueue analyzed;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::thread reader;
+    std::thread worker;
+
+    void readBlocks();
+    void analyzeBlocks();
+    void fail();
+
+public:
+    ReadPipeline(const HMM_DNA_Analyzer& analizador, const std::string& ruta, bool solo_evaluacion = false,
+                 size_t bases_por_bloque = 1 << 22, size_t bloques_en_cola = 4);
+    ~ReadPipeline();
+
+    ReadPipeline(const ReadPipeline&) = delete;
+    ReadPipeline& operator=(const ReadPipeline&) = delete;
+
+    /**
+     * @brief Siguiente bloque analizado, en el orden del archivo
+     *
+     * Espera a que esté listo. Devuelve false al terminar el archivo;
+     * relanza el primer error de lectura, de formato o de análisis.
+     */
+    bool siguiente(BloqueLecturas& bloque);
+};
+
+/**
+ * @brief Escritor de regiones en BED o GFF3 con escritura por bloques
+ *
+ * Las líneas se formatean en un buffer de memoria que se vuelca al
+ * archivo en bloques grandes, así que puede alimentarse región a región o
+ * resultado a resultado (registros de MappedFasta, bloques de
+ * ReadPipeline, regiones de StreamingViterbi) sin acumular el genoma.
+ *
+ * formato es "bed" o "gff3"; vacío, se deduce de la extensión (.gff o
+ * .gff3, si no BED). En BED (6 columnas) las posiciones empiezan en 0 y
+ * el fin es exclusivo, el nombre es el estado y la puntuación es 1000 x
+ * la media de la puntuación de cada posición. En GFF3 las posiciones
+ * empiezan en 1 con el fin incluido, el tipo es "region", la puntuación
+ * es esa media con 4 decimales y los atributos son ID y Name (el estado).
+ * En BED los espacios en blanco del cromosoma y del nombre se cambian por
+ * '_'. desplazamiento se suma a las posiciones (resultados de un tramo
+ * del cromosoma) y hebra es '+', '-' o '.'.
+ *
+ * La puntuación por posición depende del resultado: con PosteriorResult
+ * es la posterior del estado, P(estado_t | secuencia); con los resultados
+ * de Viterbi es la puntuación Viterbi de la columna (probabilidades de
+ * reconocimiento()), que no es una posterior.
+ */
+class RegionWriter {
+private:
+    std::FILE* file;
+    std::string path;
+    bool gff3;
+    std::string buffer;
+    size_t num_regions;
+
+    // Columnas ya escapadas (GFF3) o con los espacios cambiados por '_' (BED)
+    std::string column(const std::string& text, bool name) const;
+    std::vector<std::string> stateColumns(const std::vector<std::string>& names) const;
+    void writeRegion(const std::string& chromosome, size_t start, size_t end, const std::string& name,
+                     const double* probs, char strand);
+    void flush();
+
+public:
+    explicit RegionWriter(const std::string& ruta, const std::string& formato = "");
+    ~RegionWriter();
+
+    RegionWriter(const RegionWriter&) = delete;
+    RegionWriter& operator=(const RegionWriter&) = delete;
+
+    /**
+     * @brief Regiones del camino de máxima posterior, puntuadas con la posterior media
+     *
+     * Cada región es un tramo de estado constante de codigos.
+     */
+    void escribir(const std::string& cromosoma, const PosteriorResult& posterior, size_t desplazamiento = 0,
+                  char hebra = '.');
+
+    /**
+     * @brief Regiones de Viterbi, puntuadas con la puntuación Viterbi media
+     */
+    void escribir(const std::string& cromosoma, const AnalysisResult& analisis, size_t desplazamiento = 0,
+                  char hebra = '.');
+    void escribir(const std::string& cromosoma, const AnalisisCompacto& analisis, size_t desplazamiento = 0,
+                  char hebra = '.');
+
+    /**
+     * @brief Regiones sin probabilidades (p. ej. StreamingViterbi::tomar_regiones())
+     *
+     * Se escriben sin puntuación (0 en BED, "." en GFF3) y con el tipo de
+     * región como nombre.
+     */
+    void escribir(const std::string& cromosoma, const std::vector<Region>& regiones, size_t desplazamiento = 0,
+                  char hebra = '.');
+
+    /**
+     * @brief Regiones de cada lectura de un bloque de ReadPipeline (con
+     * análisis), puntuadas con la puntuación Viterbi media
+     */
+    void escribir(const BloqueLecturas& bloque, char hebra = '.');
+
+    /**
+     * @brief Vuelca el buffer y cierra el archivo (también lo hace el destructor)
+     */
+    void cerrar();
+};
+
+/**
+ * @brief Huella del modelo: hash FNV-1a de 64 bits de los nombres de
+ * estados y símbolos y de las probabilidades de inicio, transición y
+ * emisión (bit a bit)
+ *
+ * Dos analizadores con los mismos parámetros (p. ej. un modelo y el mismo
+ * modelo guardado y vuelto a cargar con guardar_modelo_json) tienen la
+ * misma huella; cualquier cambio de parámetros la cambia.
+ */
+uint64_t huella_modelo(const HMM_DNA_Analyzer& analizador);
+
+/**
+ * @brief Escritor de resultados de decodificación en formato binario
+ * compacto, para reabrirlos con MappedResults sin volver a decodificar
+ *
+ * Cada registro (un cromosoma, una lectura) guarda:
+ *  - la pista de estados codificada por tramos (inicio y estado de cada
+ *    tramo de estado constante, que son las regiones de
+ *    analizar_regiones()), con la probabilidad media de cada región;
+ *  - un índice de rango sobre los inicios de tramo (1,125 bits por
+ *    posición) para saber en O(1) en qué tramo cae cualquier posición;
+ *  - la probabilidad de cada posición cuantizada a 8 bits (error máximo
+ *    1/510).
+ * La cabecera guarda los nombres de los estados y huella_modelo() del
+ * analizador, y al cerrar se añade el índice de registros. Los enteros se
+ * escriben en el orden de bytes de la máquina.
+ *
+ * Los resultados deben venir del mismo modelo que el analizador (mismos
+ * estados); si no, lanza std::invalid_argument.
+ */
+class ResultWriter {
+private:
+    std::FILE* file;
+    std::string path;
+    std::vector<std::string> state_names;
+    uint64_t fingerprint;
+    uint64_t offset;
+    std::vector<uint64_t> entries;  // RESULT_ENTRY_WORDS por registro
+    std::string name_pool;
+
+    void write(const void* bytes, size_t size);
+    void align();
+    void checkStates(const std::vector<std::string>& names) const;
+    void writeRecord(const std::string& name, const unsigned char* codes, const double* probs, size_t n);
+
+public:
+    ResultWriter(const std::string& ruta, const HMM_DNA_Analyzer& analizador);
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    void escribir(const std::string& nombre, const AnalysisResult& analisis);
+    void escribir(const std::string& nombre, const AnalisisCompacto& analisis);
+
+    /**
+     * @brief Camino de máxima posterior con su posterior en cada posición
+     */
+    void escribir(const std::string& nombre, const PosteriorResult& posterior);
+
+    /**
+     * @brief Cada lectura de un bloque de ReadPipeline (con análisis) como
+     * un registro, salvo las rechazadas
+     */
+    void escribir(const BloqueLecturas& bloque);
+
+    /**
+     * @brief Escribe el índice de registros y cierra el archivo (también lo
+     * hace el destructor; sin índice el archivo no se puede abrir)
+     */
+    void cerrar();
+};
+
+/**
+ * @brief Archivo de ResultWriter proyectado en memoria
+ *
+ * Solo se leen la cabecera y el índice de registros; estado() y
+ * probabilidad() de cualquier posición, y las regiones que cortan un
+ * intervalo, se consultan en O(1) directamente sobre la proyección, sin
+ * copiar el registro ni volver a ejecutar reconocimiento(). Las regiones
+ * se devuelven como RegionCompacta con el fin incluido.
+ *
+ * Al abrir se comprueban la cabecera y los límites de cada sección; el
+ * contenido de los tramos (inicios crecientes, estados válidos, índice de
+ * rango) se comprueba al consultar cada tramo, de modo que un archivo
+ * corrupto da std::runtime_error en vez de leer fuera de la proyección.
+ */
+class MappedResults {
+private:
+    struct Record {
+        std::string name;
+        size_t length;
+        size_t num_runs;
+        const uint64_t* starts;  // num_runs + 1, el último es length
+        const float* means;
+        const unsigned char* states;
+        const uint64_t* rank;
+        const unsigned char* probs;
+    };
+
+    std::string path;
+    const char* data;
+    size_t num_bytes;
+    uint64_t fingerprint;
+    std::vector<std::string> state_names;
+    std::vector<Record> records;
+    std::unordered_map<std::string, size_t> names;
+
+    void parse();
+    const Record& record(size_t i) const;
+    void checkRun(const Record& record, size_t run) const;
+    size_t runAt(const Record& record, size_t position) const;
+
+public:
+    explicit MappedResults(const std::string& ruta);
+    ~MappedResults();
+
+    MappedResults(const MappedResults&) = delete;
+    MappedResults& operator=(const MappedResults&) = delete;
+
+    size_t num_registros() const;
+    std::string nombre(size_t i) const;
+    size_t longitud(size_t i) const;
+
+    /**
+     * @brief Posición del registro con ese nombre (std::invalid_argument si no existe)
+     */
+    size_t buscar(const std::string& nombre) const;
+
+    std::vector<std::string> nombres_estados() const;
+    uint64_t huella_modelo() const;
+
+    /**
+     * @brief true si el archivo se escribió con un modelo igual al del analizador
+     */
+    bool compatible(const HMM_DNA_Analyzer& analizador) const;
+
+    /**
+     * @brief Índice (en nombres_estados()) del estado en una posición del registro i
+     */
+    unsigned char estado(size_t i, size_t posicion) const;
+
+    /**
+     * @brief Probabilidad de la posición, cuantizada a 8 bits
+     */
+    double probabilidad(size_t i, size_t posicion) const;
+
+    /**
+     * @brief Códigos de estado de [inicio, fin) del registro i
+     */
+    std::vector<unsigned char> codigos(size_t i, size_t inicio, size_t fin) const;
+
+    size_t num_regiones(size_t i) const;
+    RegionCompacta region(size_t i, size_t k) const;
+
+    /**
+     * @brief Índice de la región del registro i que contiene la posición
+     */
+    size_t region_en(size_t i, size_t posicion) const;
+
+    /**
+     * @brief Probabilidad media de la región k del registro i (en float, sin cuantizar a 8 bits)
+     */
+    double probabilidad_media(size_t i, size_t k) const;
+
+    /**
+     * @brief Regiones del registro i que cortan [inicio, fin)
+     */
+    std::vector<RegionCompacta> regiones(size_t i, size_t inicio, size_t fin) const;
+};
+
+#endif // HMM_IO_H
@@ -1,236 +1,3283 @@
 #include "HMMmethods.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const double NEG_INF = -std::numeric_limits<double>::infinity();
+
+/**
+ * Kernels con el número de estados fijo en compilación. Los pasos de las
+ * recurrencias se instancian con S = 2, 4 y 8 (los tamaños habituales;
+ * el modelo por defecto tiene 2 estados) y con S = 0, que usa el número de
+ * estados del modelo en tiempo de ejecución, para el resto. Con S fijo los
+ * bucles sobre estados se desenrollan por completo. Las operaciones y su
+ * orden son los mismos en ambos casos, así que los resultados son
+ * idénticos.
+ */
+template <int S>
+inline int stateCount(const CompiledModel& model) {
+    return S > 0 ? S : model.num_states;
+}
+
+// Desenrollado de los bucles sobre estados (-O2 no desenrolla por sí solo)
+#if defined(__clang__)
+#define HMM_UNROLL_STATES _Pragma("unroll 8")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define HMM_UNROLL_STATES _Pragma("GCC unroll 8")
+#else
+#define HMM_UNROLL_STATES
+#endif
+
+/**
+ * Resta el máximo a una columna en espacio logarítmico y lo devuelve.
+ * Si toda la columna es -inf (secuencia imposible) se deja igual.
+ */
+template <int S = 0>
+inline double normalizeLogColumn(double* column, int num_states) {
+    double col_max = column[0];
+    HMM_UNROLL_STATES
+    for (int i = 1; i < num_states; i++) {
+        if (col_max < column[i]) col_max = column[i];
+    }
+    if (col_max == NEG_INF) return NEG_INF;
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        column[i] -= col_max;
+    }
+    return col_max;
+}
+
+// Columna inicial de Viterbi (t=0), normalizada
+template <int S = 0>
+inline double viterbiInit(const CompiledModel& model, int symbol, double* curr) {
+    const int num_states = stateCount<S>(model);
+    const double* log_emit = &model.log_emit[symbol * num_states];
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        curr[i] = model.log_start[i] + log_emit[i];
+    }
+    return normalizeLogColumn<S>(curr, num_states);
+}
+
+/**
+ * Un paso de Viterbi en espacio logarítmico:
+ * curr[i] = max_j(prev[j] + log P(i|j)) + log P(symbol|i), normalizado.
+ * Los empates se resuelven a favor del estado anterior de menor índice.
+ */
+template <int S = 0>
+inline double viterbiStep(const CompiledModel& model, const double* prev, int symbol,
+                          double* curr, int* backptr) {
+    const int num_states = stateCount<S>(model);
+    const double* log_trans = model.log_trans.data();
+    const double* log_emit = &model.log_emit[symbol * num_states];
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        int best_prev = 0;
+        double best_score = prev[0] + log_trans[i];
+        HMM_UNROLL_STATES
+        for (int j = 1; j < num_states; j++) {
+            double score = prev[j] + log_trans[j * num_states + i];
+            if (score > best_score) {
+                best_score = score;
+                best_prev = j;
+            }
+        }
+        curr[i] = best_score + log_emit[i];
+        backptr[i] = best_prev;
+    }
+    return normalizeLogColumn<S>(curr, num_states);
+}
+
+// Escala una columna forward para que sume 1 y devuelve el factor c_t
+template <int S = 0>
+inline double scaleColumn(double* column, int num_states) {
+    double sum = 0.0;
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        sum += column[i];
+    }
+    if (sum > 0.0) {
+        double inv = 1.0 / sum;
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            column[i] *= inv;
+        }
+    }
+    return sum;
+}
+
+// Columna inicial forward (t=0), escalada
+template <int S = 0>
+inline double forwardInit(const CompiledModel& model, int symbol, double* curr) {
+    const int num_states = stateCount<S>(model);
+    const double* emit = &model.emit[symbol * num_states];
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        curr[i] = model.start[i] * emit[i];
+    }
+    return scaleColumn<S>(curr, num_states);
+}
+
+// Un paso forward escalado: curr[i] = sum_j(prev[j] * P(i|j)) * P(symbol|i) / c_t
+template <int S = 0>
+inline double forwardStep(const CompiledModel& model, const double* prev, int symbol, double* curr) {
+    const int num_states = stateCount<S>(model);
+    const double* trans = model.trans.data();
+    const double* emit = &model.emit[symbol * num_states];
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        double sum = 0.0;
+        HMM_UNROLL_STATES
+        for (int j = 0; j < num_states; j++) {
+            sum += prev[j] * trans[j * num_states + i];
+        }
+        curr[i] = sum * emit[i];
+    }
+    return scaleColumn<S>(curr, num_states);
+}
+
+/**
+ * Un paso backward escalado con el mismo c_t que la pasada forward:
+ * curr[j] = sum_i P(i|j) * P(symbol|i) * next[i] / c_t. weighted es
+ * memoria auxiliar de num_states elementos.
+ */
+template <int S = 0>
+inline void backwardStep(const CompiledModel& model, const double* next, int symbol, double scale,
+                         double* weighted, double* curr) {
+    const int num_states = stateCount<S>(model);
+    const double* trans = model.trans.data();
+    const double* emit = &model.emit[symbol * num_states];
+    double inv = (scale > 0.0) ? 1.0 / scale : 0.0;
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        weighted[i] = emit[i] * next[i];
+    }
+    HMM_UNROLL_STATES
+    for (int j = 0; j < num_states; j++) {
+        double sum = 0.0;
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            sum += trans[j * num_states + i] * weighted[i];
+        }
+        curr[j] = sum * inv;
+    }
+}
+
+/**
+ * Posterior de una columna: gamma[i] = alpha[i] * beta[i] normalizado
+ * (gamma puede ser alpha). Devuelve el estado de mayor posterior; los
+ * empates se resuelven a favor del menor índice.
+ */
+template <int S = 0>
+inline int posteriorColumn(const double* alpha, const double* beta, int num_states, double* gamma) {
+    double sum = 0.0;
+    HMM_UNROLL_STATES
+    for (int i = 0; i < num_states; i++) {
+        gamma[i] = alpha[i] * beta[i];
+        sum += gamma[i];
+    }
+    int best = 0;
+    if (sum > 0.0) {
+        double inv = 1.0 / sum;
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            gamma[i] *= inv;
+            if (gamma[i] > gamma[best]) best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * Punteros de retroceso de Viterbi empaquetados en palabras de 64 bits.
+ * Cada puntero ocupa la menor potencia de dos de bits que representa
+ * num_states estados (1 bit para el modelo H/L), de modo que nunca cruza
+ * el límite de una palabra.
+ */
+class BacktrackStore {
+private:
+    std::vector<uint64_t> words;
+    size_t num_states;
+    int bits;
+
+public:
+    BacktrackStore(size_t n, size_t num_states) : num_states(num_states), bits(1) {
+        while (bits < 8 && ((size_t)1 << bits) < num_states) bits *= 2;
+        words.assign((n * num_states * bits + 63) / 64, 0);
+    }
+
+    // Ajusta la capacidad a n posiciones sin liberar memoria; set() sobrescribe
+    void resize(size_t n) {
+        words.resize((n * num_states * bits + 63) / 64);
+    }
+
+    void clear() {
+        std::fill(words.begin(), words.end(), 0);
+    }
+
+    template <int S = 0>
+    void set(size_t t, const int* backptr) {
+        const size_t count = S > 0 ? S : num_states;
+        uint64_t mask = ((uint64_t)1 << bits) - 1;
+        size_t offset = t * count * bits;
+        HMM_UNROLL_STATES
+        for (size_t i = 0; i < count; i++, offset += bits) {
+            uint64_t& word = words[offset >> 6];
+            word = (word & ~(mask << (offset & 63))) | ((uint64_t)backptr[i] << (offset & 63));
+        }
+    }
+
+    int get(size_t t, int state) const {
+        size_t offset = (t * num_states + state) * bits;
+        return (words[offset >> 6] >> (offset & 63)) & (((uint64_t)1 << bits) - 1);
+    }
+};
+
+// Memoria de trabajo de los kernels por carriles (símbolos intercalados y punteros)
+struct LaneBuffers {
+    std::vector<long long> symbols;
+    std::vector<unsigned char> backptrs;
+};
+
+// Memoria de trabajo de Viterbi reutilizable entre secuencias
+struct ViterbiWorkspace {
+    std::vector<double> prev, curr;
+    std::vector<double> forward_prev, forward_curr;
+    std::vector<int> backptr;
+    BacktrackStore path;
+    LaneBuffers lanes;
+
+    explicit ViterbiWorkspace(int num_states)
+        : prev(num_states), curr(num_states), forward_prev(num_states), forward_curr(num_states),
+          backptr(num_states), path(0, num_states) {}
+};
+
+/**
+ * Viterbi completo sobre una secuencia: escribe el mejor camino y las
+ * probabilidades V[best][t] / sum_i V[i][t] en los buffers del llamador y
+ * devuelve log P del mejor camino (region_probs puede ser NULL si sólo se
+ * necesita el camino). Sólo guarda dos columnas de V y los
+ * punteros empaquetados; las columnas se recalculan en una segunda pasada
+ * (los pasos son deterministas y dan los mismos valores).
+ *
+ * Si forward_log_prob no es NULL, en la misma pasada (con la misma lectura
+ * de cada símbolo) se calcula también log P(secuencia) con Forward
+ * escalado; el valor es idéntico al de forwardLogLikelihood.
+ */
+template <int S, typename Symbols>
+double viterbiDecodeKernel(const CompiledModel& model, const Symbols& symbols, size_t n, ViterbiWorkspace& ws,
+                           unsigned char* best_path, double* region_probs, double* forward_log_prob) {
+    const int num_states = stateCount<S>(model);
+    double* prev = &ws.prev[0];
+    double* curr = &ws.curr[0];
+    int* backptr = &ws.backptr[0];
+    ws.path.resize(n);
+
+    // Inicialización (t=0)
+    double log_prob = viterbiInit<S>(model, symbols[0], prev);
+
+    // Recursión (t=1 to n-1)
+    if (forward_log_prob) {
+        double* forward_prev = &ws.forward_prev[0];
+        double* forward_curr = &ws.forward_curr[0];
+        ScaleAccumulator scale;
+        scale.add(forwardInit<S>(model, symbols[0], forward_prev));
+        for (size_t t = 1; t < n; t++) {
+            int symbol = symbols[t];
+            log_prob += viterbiStep<S>(model, prev, symbol, curr, backptr);
+            ws.path.set<S>(t, backptr);
+            std::swap(prev, curr);
+            scale.add(forwardStep<S>(model, forward_prev, symbol, forward_curr));
+            std::swap(forward_prev, forward_curr);
+        }
+        *forward_log_prob = scale.log();
+    } else {
+        for (size_t t = 1; t < n; t++) {
+            log_prob += viterbiStep<S>(model, prev, symbols[t], curr, backptr);
+            ws.path.set<S>(t, backptr);
+            std::swap(prev, curr);
+        }
+    }
+
+    // Terminación y backtracking
+    int state = std::max_element(prev, prev + num_states) - prev;
+    for (size_t t = n - 1; t > 0; t--) {
+        best_path[t] = state;
+        state = ws.path.get(t, state);
+    }
+    best_path[0] = state;
+
+    // Probabilidades de cada región recalculando las columnas
+    for (size_t t = 0; region_probs && t < n; t++) {
+        if (t == 0) {
+            viterbiInit<S>(model, symbols[0], curr);
+        } else {
+            viterbiStep<S>(model, prev, symbols[t], curr, backptr);
+        }
+        double sum_probs = 0.0, best_prob = 0.0;
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            double prob = std::exp(curr[i]);
+            sum_probs += prob;
+            if (i == best_path[t]) best_prob = prob;
+        }
+        region_probs[t] = (sum_probs > 0) ? best_prob / sum_probs : 0.0;
+        std::swap(prev, curr);
+    }
+
+    return log_prob;
+}
+
+// Elige el kernel de Viterbi según el número de estados del modelo
+template <typename Symbols>
+double viterbiDecode(const CompiledModel& model, const Symbols& symbols, size_t n, ViterbiWorkspace& ws,
+                     unsigned char* best_path, double* region_probs, double* forward_log_prob = NULL) {
+    switch (model.num_states) {
+        case 2: return viterbiDecodeKernel<2>(model, symbols, n, ws, best_path, region_probs, forward_log_prob);
+        case 4: return viterbiDecodeKernel<4>(model, symbols, n, ws, best_path, region_probs, forward_log_prob);
+        case 8: return viterbiDecodeKernel<8>(model, symbols, n, ws, best_path, region_probs, forward_log_prob);
+        default: return viterbiDecodeKernel<0>(model, symbols, n, ws, best_path, region_probs, forward_log_prob);
+    }
+}
+
+// log P(secuencia) con Forward escalado; prev y curr tienen num_states elementos
+template <int S, typename Symbols>
+double forwardLogLikelihoodKernel(const CompiledModel& model, const Symbols& symbols, size_t n,
+                                  double* prev, double* curr) {
+    ScaleAccumulator scale;
+
+    // Inicialización (t=0)
+    scale.add(forwardInit<S>(model, symbols[0], prev));
+
+    // Recursión forward (t=1 to n-1)
+    for (size_t t = 1; t < n; t++) {
+        scale.add(forwardStep<S>(model, prev, symbols[t], curr));
+        std::swap(prev, curr);
+    }
+
+    return scale.log();
+}
+
+template <typename Symbols>
+double forwardLogLikelihood(const CompiledModel& model, const Symbols& symbols, size_t n,
+                            double* prev, double* curr) {
+    switch (model.num_states) {
+        case 2: return forwardLogLikelihoodKernel<2>(model, symbols, n, prev, curr);
+        case 4: return forwardLogLikelihoodKernel<4>(model, symbols, n, prev, curr);
+        case 8: return forwardLogLikelihoodKernel<8>(model, symbols, n, prev, curr);
+        default: return forwardLogLikelihoodKernel<0>(model, symbols, n, prev, curr);
+    }
+}
+
+/**
+ * Longitud de segmento para Viterbi con puntos de control. Cada punto de
+ * control guarda una columna y una fila de punteros; cada segmento
+ * recalculado guarda sus punteros empaquetados y sus columnas.
+ */
+size_t checkpointInterval(size_t n, size_t num_states, size_t memory_budget) {
+    double column_bytes = num_states * (sizeof(double) + sizeof(int));
+    double segment_bytes_per_base = num_states * (sizeof(double) + 1.0);
+
+    size_t k = (size_t)std::ceil(std::sqrt((double)n));
+    if (memory_budget > 0) {
+        // memoria(k) = ceil(n/k) * column_bytes + k * segment_bytes_per_base
+        size_t lo = k, hi = n;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo + 1) / 2;
+            double bytes = ((n + mid - 1) / mid) * column_bytes + mid * segment_bytes_per_base;
+            if (bytes <= memory_budget) lo = mid;
+            else hi = mid - 1;
+        }
+        k = lo;
+    }
+    return std::max<size_t>(k, 1);
+}
+
+/**
+ * Tabla de codificación de bases para PackedSequence: 0..3 para A/C/G/T,
+ * 4 para N y 0xFF para cualquier otro byte.
+ */
+struct BaseEncodeTable {
+    unsigned char code[256];
+
+    BaseEncodeTable() {
+        std::fill(code, code + 256, 0xFF);
+        code['A'] = code['a'] = 0;
+        code['C'] = code['c'] = 1;
+        code['G'] = code['g'] = 2;
+        code['T'] = code['t'] = 3;
+        code['N'] = code['n'] = 4;
+    }
+};
+
+const BaseEncodeTable BASE_ENCODE;
+
+/**
+ * Hilos persistentes compartidos por todos los analizadores, para no
+ * crear y unir hilos en cada llamada paralela. Crece hasta el mayor
+ * número de ayudantes pedido (getNumThreads() - 1) y no se reduce.
+ *
+ * run() encola los ayudantes de una tarea y el hilo que llama ejecuta su
+ * parte; al terminarla retira los ayudantes que ningún hilo ha empezado y
+ * espera solo a los que están en marcha. Así nunca espera a un hilo
+ * ocupado en otra tarea, y las llamadas concurrentes o anidadas (desde un
+ * hilo del pool) no se bloquean entre sí.
+ */
+class ThreadPool {
+private:
+    struct Job {
+        const std::function<void(int)>* task;
+        size_t running;
+        std::condition_variable done;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::pair<Job*, int>> queue;
+    std::vector<std::thread> workers;
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return !queue.empty(); });
+            std::pair<Job*, int> item = queue.front();
+            queue.pop_front();
+            item.first->running++;
+            lock.unlock();
+            (*item.first->task)(item.second);
+            lock.lock();
+            if (--item.first->running == 0) item.first->done.notify_all();
+        }
+    }
+
+public:
+    // Nunca se destruye: los hilos no se unen al salir del proceso
+    static ThreadPool& shared() {
+        static ThreadPool* pool = new ThreadPool();
+        return *pool;
+    }
+
+    // task(0) en el hilo que llama y task(1..helpers) en hilos del pool
+    void run(size_t helpers, const std::function<void(int)>& task) {
+        Job job;
+        job.task = &task;
+        job.running = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (workers.size() < helpers) {
+                workers.push_back(std::thread(&ThreadPool::loop, this));
+            }
+            for (size_t h = 1; h <= helpers; h++) {
+                queue.push_back(std::make_pair(&job, (int)h));
+            }
+        }
+        wake.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (std::deque<std::pair<Job*, int>>::iterator it = queue.begin(); it != queue.end();) {
+            it = it->first == &job ? queue.erase(it) : it + 1;
+        }
+        job.done.wait(lock, [&] { return job.running == 0; });
+    }
+};
+
+/**
+ * Ejecuta fn(i, hilo) para i en [0, count) con hasta `threads` hilos (el
+ * que llama y los del ThreadPool compartido) que toman índices de un
+ * contador compartido. La primera excepción lanzada por fn se relanza en
+ * el hilo que llama.
+ */
+template <typename Fn>
+void parallelFor(size_t count, int threads, Fn fn) {
+    size_t num_workers = std::min<size_t>(std::max(threads, 1), count);
+    if (num_workers <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            fn(i, 0);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto worker = [&](int thread_id) {
+        try {
+            for (size_t i = next++; i < count; i = next++) {
+                fn(i, thread_id);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next = count;
+        }
+    };
+
+    ThreadPool::shared().run(num_workers - 1, worker);
+
+    if (error) std::rethrow_exception(error);
+}
+
+/**
+ * Producto escalado de las matrices forward A_t = T * diag(E(o_t)) de un
+ * tramo [begin, end): fila a = probabilidad de cada estado al final del
+ * tramo partiendo del estado a. La matriz se normaliza para que sume 1 y
+ * el factor acumulado queda en `scale`.
+ */
+template <int S, typename Symbols>
+void forwardTransferKernel(const CompiledModel& model, const Symbols& symbols, size_t begin, size_t end,
+                           std::vector<double>& matrix, ScaleAccumulator& scale) {
+    const int num_states = stateCount<S>(model);
+    const double* trans = model.trans.data();
+    std::vector<double> row(num_states);
+
+    matrix.assign(num_states * num_states, 0.0);
+    for (int a = 0; a < num_states; a++) {
+        matrix[a * num_states + a] = 1.0;
+    }
+
+    for (size_t t = begin; t < end; t++) {
+        const double* emit = &model.emit[symbols[t] * num_states];
+        double total = 0.0;
+        for (int a = 0; a < num_states; a++) {
+            double* m = &matrix[a * num_states];
+            HMM_UNROLL_STATES
+            for (int i = 0; i < num_states; i++) {
+                double sum = 0.0;
+                HMM_UNROLL_STATES
+                for (int j = 0; j < num_states; j++) {
+                    sum += m[j] * trans[j * num_states + i];
+                }
+                row[i] = sum * emit[i];
+                total += row[i];
+            }
+            std::copy(row.begin(), row.end(), m);
+        }
+        scale.add(total);
+        if (total > 0.0) {
+            double inv = 1.0 / total;
+            for (size_t k = 0; k < matrix.size(); k++) {
+                matrix[k] *= inv;
+            }
+        }
+    }
+}
+
+template <typename Symbols>
+void forwardTransfer(const CompiledModel& model, const Symbols& symbols, size_t begin, size_t end,
+                     std::vector<double>& matrix, ScaleAccumulator& scale) {
+    switch (model.num_states) {
+        case 2: return forwardTransferKernel<2>(model, symbols, begin, end, matrix, scale);
+        case 4: return forwardTransferKernel<4>(model, symbols, begin, end, matrix, scale);
+        case 8: return forwardTransferKernel<8>(model, symbols, begin, end, matrix, scale);
+        default: return forwardTransferKernel<0>(model, symbols, begin, end, matrix, scale);
+    }
+}
+
+/**
+ * Matriz de transferencia (max, +) de un tramo [begin, end): fila a =
+ * mejor log-puntuación de cada estado al final del tramo partiendo del
+ * estado a. Se normaliza a máximo 0 en cada paso; devuelve la suma de lo
+ * restado.
+ */
+template <int S, typename Symbols>
+double viterbiTransferKernel(const CompiledModel& model, const Symbols& symbols, size_t begin, size_t end,
+                             std::vector<double>& matrix) {
+    const int num_states = stateCount<S>(model);
+    const double* log_trans = model.log_trans.data();
+    std::vector<double> row(num_states);
+    double offset = 0.0;
+
+    matrix.assign(num_states * num_states, NEG_INF);
+    for (int a = 0; a < num_states; a++) {
+        matrix[a * num_states + a] = 0.0;
+    }
+
+    for (size_t t = begin; t < end; t++) {
+        const double* log_emit = &model.log_emit[symbols[t] * num_states];
+        for (int a = 0; a < num_states; a++) {
+            double* m = &matrix[a * num_states];
+            HMM_UNROLL_STATES
+            for (int i = 0; i < num_states; i++) {
+                double best = m[0] + log_trans[i];
+                HMM_UNROLL_STATES
+                for (int j = 1; j < num_states; j++) {
+                    best = std::max(best, m[j] + log_trans[j * num_states + i]);
+                }
+                row[i] = best + log_emit[i];
+            }
+            std::copy(row.begin(), row.end(), m);
+        }
+        offset += normalizeLogColumn<S * S>(&matrix[0], num_states * num_states);
+    }
+    return offset;
+}
+
+template <typename Symbols>
+double viterbiTransfer(const CompiledModel& model, const Symbols& symbols, size_t begin, size_t end,
+                       std::vector<double>& matrix) {
+    switch (model.num_states) {
+        case 2: return viterbiTransferKernel<2>(model, symbols, begin, end, matrix);
+        case 4: return viterbiTransferKernel<4>(model, symbols, begin, end, matrix);
+        case 8: return viterbiTransferKernel<8>(model, symbols, begin, end, matrix);
+        default: return viterbiTransferKernel<0>(model, symbols, begin, end, matrix);
+    }
+}
+
+/**
+ * Conteos esperados de Baum-Welch de un tramo [begin, end) de una
+ * secuencia. alpha_in es la columna forward normalizada en begin - 1 (NULL
+ * si begin es 0) y beta_out la columna backward en end - 1 (NULL para una
+ * columna de unos, el final de la secuencia). Las posteriores de estado y
+ * de transición se normalizan por posición, así que la escala de las
+ * fronteras no importa. counts = [inicio S | transiciones S*S (j * S + i,
+ * de j a i) | emisiones M*S (k * S + i)]. Devuelve la suma de log(c_t) del
+ * tramo; columns y scales son memoria de trabajo.
+ */
+template <int S, typename Symbols>
+double trainingCountsKernel(const CompiledModel& model, const Symbols& symbols, size_t begin, size_t end,
+                            const double* alpha_in, const double* beta_out, std::vector<double>& columns,
+                            std::vector<double>& scales, double* counts) {
+    const int num_states = stateCount<S>(model);
+    size_t length = end - begin;
+    const double* trans = model.trans.data();
+    double* start_counts = counts;
+    double* trans_counts = counts + num_states;
+    double* emit_counts = trans_counts + num_states * num_states;
+
+    // Forward del tramo guardando todas sus columnas
+    columns.resize(length * num_states);
+    scales.resize(length);
+    ScaleAccumulator scale;
+    if (begin == 0) {
+        scales[0] = forwardInit<S>(model, symbols[0], &columns[0]);
+    } else {
+        scales[0] = forwardStep<S>(model, alpha_in, symbols[begin], &columns[0]);
+    }
+    scale.add(scales[0]);
+    for (size_t t = 1; t < length; t++) {
+        scales[t] = forwardStep<S>(model, &columns[(t - 1) * num_states], symbols[begin + t], &columns[t * num_states]);
+        scale.add(scales[t]);
+    }
+
+    // Backward acumulando posteriores de estado y de transición
+    std::vector<double> beta(num_states, 1.0), prev_beta(num_states), weighted(num_states);
+    std::vector<double> gamma(num_states), xi(num_states * num_states);
+    if (beta_out) std::copy(beta_out, beta_out + num_states, beta.begin());
+
+    for (size_t t = length; t-- > 0;) {
+        size_t pos = begin + t;
+        int symbol = symbols[pos];
+        const double* emit = &model.emit[symbol * num_states];
+
+        posteriorColumn<S>(&columns[t * num_states], &beta[0], num_states, &gamma[0]);
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            emit_counts[symbol * num_states + i] += gamma[i];
+        }
+        if (pos == 0) {
+            for (int i = 0; i < num_states; i++) {
+                start_counts[i] += gamma[i];
+            }
+            continue;
+        }
+
+        const double* prev_alpha = (t > 0) ? &columns[(t - 1) * num_states] : alpha_in;
+        double total = 0.0;
+        HMM_UNROLL_STATES
+        for (int j = 0; j < num_states; j++) {
+            HMM_UNROLL_STATES
+            for (int i = 0; i < num_states; i++) {
+                double x = prev_alpha[j] * trans[j * num_states + i] * emit[i] * beta[i];
+                xi[j * num_states + i] = x;
+                total += x;
+            }
+        }
+        if (total > 0.0) {
+            double inv = 1.0 / total;
+            for (int k = 0; k < num_states * num_states; k++) {
+                trans_counts[k] += xi[k] * inv;
+            }
+        }
+
+        backwardStep<S>(model, &beta[0], symbol, scales[t], &weighted[0], &prev_beta[0]);
+        beta.swap(prev_beta);
+    }
+
+    return scale.log();
+}
+
+template <typename Symbols>
+double trainingCounts(const CompiledModel& model, const Symbols& symbols, size_t begin, size_t end,
+                      const double* alpha_in, const double* beta_out, std::vector<double>& columns,
+                      std::vector<double>& scales, double* counts) {
+    switch (model.num_states) {
+        case 2: return trainingCountsKernel<2>(model, symbols, begin, end, alpha_in, beta_out, columns, scales, counts);
+        case 4: return trainingCountsKernel<4>(model, symbols, begin, end, alpha_in, beta_out, columns, scales, counts);
+        case 8: return trainingCountsKernel<8>(model, symbols, begin, end, alpha_in, beta_out, columns, scales, counts);
+        default:
+            return trainingCountsKernel<0>(model, symbols, begin, end, alpha_in, beta_out, columns, scales, counts);
+    }
+}
+
+// Conteos de un camino decodificado, con la misma disposición que trainingCounts
+template <typename Symbols>
+void pathCounts(const CompiledModel& model, const Symbols& symbols, const unsigned char* path, size_t n,
+                double* counts) {
+    int num_states = model.num_states;
+    double* trans_counts = counts + num_states;
+    double* emit_counts = trans_counts + num_states * num_states;
+
+    counts[path[0]] += 1.0;
+    emit_counts[symbols[0] * num_states + path[0]] += 1.0;
+    for (size_t t = 1; t < n; t++) {
+        trans_counts[path[t - 1] * num_states + path[t]] += 1.0;
+        emit_counts[symbols[t] * num_states + path[t]] += 1.0;
+    }
+}
+
+// log P de un camino: log inicio + transiciones + emisiones, sumados en orden
+template <typename Symbols>
+double pathLogProb(const CompiledModel& model, const Symbols& symbols, const unsigned char* path, size_t n) {
+    int num_states = model.num_states;
+    double log_prob = model.log_start[path[0]] + model.log_emit[symbols[0] * num_states + path[0]];
+    for (size_t t = 1; t < n; t++) {
+        log_prob += model.log_trans[path[t - 1] * num_states + path[t]];
+        log_prob += model.log_emit[symbols[t] * num_states + path[t]];
+    }
+    return log_prob;
+}
+
+// Lecturas que procesa cada tarea de los métodos batch
+const size_t BATCH_BLOCK = 256;
+
+// Lecturas de un vector de secuencias: punteros y offsets de salida
+void collectReads(const std::vector<std::string>& sequences, std::vector<const char*>& reads,
+                  std::vector<size_t>& offsets) {
+    reads.resize(sequences.size());
+    offsets.resize(sequences.size() + 1);
+    offsets[0] = 0;
+    for (size_t r = 0; r < sequences.size(); r++) {
+        reads[r] = sequences[r].data();
+        offsets[r + 1] = offsets[r] + sequences[r].size();
+    }
+}
+
+// Lecturas de un buffer concatenado, comprobando los offsets
+void collectReads(const char* data, size_t length, const std::vector<size_t>& offsets,
+                  std::vector<const char*>& reads) {
+    if (offsets.empty() || offsets[0] != 0 || offsets.back() != length) {
+        throw std::invalid_argument("Offsets inválidos: deben empezar en 0 y terminar en la longitud del buffer");
+    }
+    reads.resize(offsets.size() - 1);
+    for (size_t r = 0; r + 1 < offsets.size(); r++) {
+        if (offsets[r + 1] < offsets[r]) {
+            throw std::invalid_argument("Offsets inválidos: deben ser crecientes");
+        }
+        reads[r] = data + offsets[r];
+    }
+}
+
+/**
+ * Kernels por carriles SIMD para los métodos batch. Con pocos estados una
+ * columna no llena un registro vectorial, así que se avanzan L lecturas
+ * independientes a la vez, una por carril, con las columnas intercaladas
+ * (el estado i de las L lecturas en un mismo vector). Cada carril hace
+ * exactamente las mismas operaciones, en el mismo orden, que
+ * viterbiDecode y forwardLogLikelihood, así que los resultados son
+ * idénticos a los del kernel escalar. Solo se usan con S fijo (2, 4 u 8
+ * estados), hasta LANE_MAX_SYMBOLS símbolos y lecturas de hasta
+ * LANE_MAX_LENGTH bases; el resto sigue por el camino escalar.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9 && defined(__x86_64__)
+#define HMM_SIMD_LANES 1
+#endif
+
+// Carriles máximos (AVX-512: 8 doubles)
+const int MAX_LANES = 8;
+
+// Símbolos máximos: la emisión de cada carril se elige con una cadena de selecciones
+const int LANE_MAX_SYMBOLS = 8;
+
+// Longitud máxima de lectura en los kernels por carriles (acota la memoria de trabajo)
+const size_t LANE_MAX_LENGTH = 1 << 16;
+
+// Lecturas de un grupo de carriles y dónde escribir sus resultados
+struct LaneBatch {
+    const char* reads[MAX_LANES];
+    size_t lengths[MAX_LANES];
+    unsigned char* paths[MAX_LANES];
+    double* region_probs[MAX_LANES];
+    double* log_probs[MAX_LANES];
+    double* forward_log_probs[MAX_LANES];  // NULL si no se pide log P(secuencia)
+};
+
+#ifdef HMM_SIMD_LANES
+
+#define HMM_LANE_INLINE inline __attribute__((always_inline))
+
+// Las funciones con vectores como valor se expanden siempre en línea dentro
+// de las funciones con target, así que el aviso de cambio de ABI no aplica
+// (GCC lo emite al instanciar las plantillas, al final de la unidad)
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// Vectores de L doubles, máscaras de comparación y bytes del mismo número de carriles
+template <int L>
+struct LaneTypes;
+
+template <>
+struct LaneTypes<4> {
+    typedef double Vec __attribute__((vector_size(32)));
+    typedef long long Mask __attribute__((vector_size(32)));
+    typedef unsigned char Bytes __attribute__((vector_size(4)));
+};
+
+template <>
+struct LaneTypes<8> {
+    typedef double Vec __attribute__((vector_size(64)));
+    typedef long long Mask __attribute__((vector_size(64)));
+    typedef unsigned char Bytes __attribute__((vector_size(8)));
+};
+
+template <int L>
+struct Lanes {
+    typedef typename LaneTypes<L>::Vec Vec;
+    typedef typename LaneTypes<L>::Mask Mask;
+    typedef typename LaneTypes<L>::Bytes Bytes;
+
+    static HMM_LANE_INLINE Vec splat(double x) {
+        return Vec{} + x;
+    }
+
+    static HMM_LANE_INLINE Mask splat(long long x) {
+        return Mask{} + x;
+    }
+
+    // Algún carril distinto de 0
+    static HMM_LANE_INLINE bool any(const Mask& m) {
+        long long bits = 0;
+        for (int l = 0; l < L; l++) bits |= m[l];
+        return bits != 0;
+    }
+
+    // Impide que el compilador fusione a * b + c en una FMA, que redondea distinto
+    static HMM_LANE_INLINE void fence(Vec& v) {
+        asm("" : "+x"(v));
+    }
+
+    /**
+     * Símbolos de una posición: is_symbol[k] marca los carriles cuyo
+     * símbolo es k (k >= 1; el resto tiene el símbolo 0).
+     */
+    struct Column {
+        Mask is_symbol[LANE_MAX_SYMBOLS];
+        int num_symbols;
+
+        HMM_LANE_INLINE Column(const long long* symbols, int num_symbols) : num_symbols(num_symbols) {
+            Mask symbol;
+            std::memcpy(&symbol, symbols, sizeof(symbol));
+            for (int k = 1; k < num_symbols; k++) {
+                is_symbol[k] = symbol == splat((long long)k);
+            }
+        }
+
+        // table[symbol * S + i] de cada carril, sin gather
+        template <int S>
+        HMM_LANE_INLINE Vec select(const double* table, int i) const {
+            Vec value = splat(table[i]);
+            for (int k = 1; k < num_symbols; k++) {
+                value = is_symbol[k] ? splat(table[k * S + i]) : value;
+            }
+            return value;
+        }
+    };
+
+    // normalizeLogColumn por carril
+    template <int S>
+    static HMM_LANE_INLINE Vec normalize(Vec* column) {
+        Vec col_max = column[0];
+        for (int i = 1; i < S; i++) {
+            col_max = (col_max < column[i]) ? column[i] : col_max;
+        }
+        Mask finite = col_max != splat(NEG_INF);
+        for (int i = 0; i < S; i++) {
+            column[i] = finite ? column[i] - col_max : column[i];
+        }
+        return col_max;
+    }
+
+    template <int S>
+    static HMM_LANE_INLINE Vec viterbiInit(const CompiledModel& model, const Column& symbols, Vec* curr) {
+        for (int i = 0; i < S; i++) {
+            curr[i] = splat(model.log_start[i]) + symbols.template select<S>(model.log_emit.data(), i);
+        }
+        return normalize<S>(curr);
+    }
+
+    // viterbiStep por carril; backptr[i] recibe el mejor estado anterior de cada carril
+    template <int S>
+    static HMM_LANE_INLINE Vec viterbiStep(const CompiledModel& model, const Vec* prev, const Column& symbols,
+                                           Vec* curr, Mask* backptr) {
+        const double* log_trans = model.log_trans.data();
+        for (int i = 0; i < S; i++) {
+            Mask best_prev = splat(0LL);
+            Vec best_score = prev[0] + splat(log_trans[i]);
+            for (int j = 1; j < S; j++) {
+                Vec score = prev[j] + splat(log_trans[j * S + i]);
+                Mask better = score > best_score;
+                best_score = better ? score : best_score;
+                best_prev = better ? splat((long long)j) : best_prev;
+            }
+            curr[i] = best_score + symbols.template select<S>(model.log_emit.data(), i);
+            backptr[i] = best_prev;
+        }
+        return normalize<S>(curr);
+    }
+
+    // scaleColumn por carril
+    template <int S>
+    static HMM_LANE_INLINE Vec scale(Vec* column) {
+        Vec sum = splat(0.0);
+        for (int i = 0; i < S; i++) {
+            sum = sum + column[i];
+        }
+        Mask positive = sum > splat(0.0);
+        Vec inv = splat(1.0) / sum;
+        for (int i = 0; i < S; i++) {
+            column[i] = positive ? column[i] * inv : column[i];
+        }
+        return sum;
+    }
+
+    template <int S>
+    static HMM_LANE_INLINE Vec forwardInit(const CompiledModel& model, const Column& symbols, Vec* curr) {
+        for (int i = 0; i < S; i++) {
+            curr[i] = splat(model.start[i]) * symbols.template select<S>(model.emit.data(), i);
+            fence(curr[i]);
+        }
+        return scale<S>(curr);
+    }
+
+    template <int S>
+    static HMM_LANE_INLINE Vec forwardStep(const CompiledModel& model, const Vec* prev, const Column& symbols,
+                                           Vec* curr) {
+        const double* trans = model.trans.data();
+        for (int i = 0; i < S; i++) {
+            Vec sum = splat(0.0);
+            for (int j = 0; j < S; j++) {
+                Vec product = prev[j] * splat(trans[j * S + i]);
+                fence(product);
+                sum = sum + product;
+            }
+            curr[i] = sum * symbols.template select<S>(model.emit.data(), i);
+            fence(curr[i]);
+        }
+        return scale<S>(curr);
+    }
+
+    /**
+     * ScaleAccumulator por carril, con mantissa y exponente como vectores.
+     * El frexp vectorial es exacto para números normales; si algún carril
+     * activo da cero, subnormal, inf o NaN ese paso se hace con std::frexp.
+     */
+    struct Scale {
+        Vec mantissa;
+        Mask exponent;
+
+        HMM_LANE_INLINE Scale() : mantissa(splat(1.0)), exponent(splat(0LL)) {}
+
+        HMM_LANE_INLINE void add(const Vec& c, const Mask& active) {
+            Vec product = mantissa * c;
+            Mask bits = (Mask)product;
+            Mask field = (bits >> 52) & splat(0x7ffLL);
+            if (!any(active & ((field == splat(0LL)) | (field == splat(0x7ffLL))))) {
+                Vec normalized = (Vec)((bits & splat(~(0x7ffLL << 52))) | splat(1022LL << 52));
+                mantissa = active ? normalized : mantissa;
+                exponent += active & (field - splat(1022LL));
+                return;
+            }
+            for (int l = 0; l < L; l++) {
+                if (!active[l]) continue;
+                int e;
+                mantissa[l] = std::frexp(product[l], &e);
+                exponent[l] += e;
+            }
+        }
+
+        double log(int l) const {
+            ScaleAccumulator scale;
+            scale.mantissa = mantissa[l];
+            scale.exponent = exponent[l];
+            return scale.log();
+        }
+    };
+
+    /**
+     * Símbolos del grupo intercalados por posición (symbols[t * L + l]),
+     * con el símbolo 0 como relleno tras el final de cada lectura.
+     * Devuelve la longitud máxima y deja las longitudes en `lengths`.
+     */
+    static HMM_LANE_INLINE size_t interleave(const CompiledModel& model, const LaneBatch& batch,
+                                             std::vector<long long>& symbols, Mask& lengths) {
+        size_t n = 0;
+        for (int l = 0; l < L; l++) {
+            n = std::max(n, batch.lengths[l]);
+            lengths[l] = batch.lengths[l];
+        }
+        symbols.assign(n * L, 0);
+        for (int l = 0; l < L; l++) {
+            for (size_t t = 0; t < batch.lengths[l]; t++) {
+                symbols[t * L + l] = model.symbol_index[(unsigned char)batch.reads[l][t]];
+            }
+        }
+        return n;
+    }
+
+    // Primer estado de máxima puntuación de un carril (como std::max_element)
+    template <int S>
+    static HMM_LANE_INLINE int argmax(const Vec* column, int l) {
+        int best = 0;
+        for (int i = 1; i < S; i++) {
+            if (column[best][l] < column[i][l]) best = i;
+        }
+        return best;
+    }
+
+    /**
+     * viterbiDecode de L lecturas (los carriles sin lectura tienen longitud
+     * 0). Los carriles que ya han terminado siguen calculando con el
+     * símbolo de relleno, pero no acumulan ni se leen.
+     */
+    template <int S>
+    static HMM_LANE_INLINE void viterbi(const CompiledModel& model, const LaneBatch& batch,
+                                        std::vector<long long>& symbol_buffer, std::vector<unsigned char>& backptrs) {
+        Mask lengths;
+        size_t n = interleave(model, batch, symbol_buffer, lengths);
+        const long long* symbols = symbol_buffer.data();
+        bool with_forward = batch.forward_log_probs[0] != NULL;
+        backptrs.resize(n * S * L);
+
+        int final_state[L];
+        Vec prev[S], curr[S], forward_prev[S], forward_curr[S];
+        Mask backptr[S];
+        Scale forward_scale;
+
+        // Inicialización (t=0)
+        Column column(symbols, model.num_symbols);
+        Vec log_prob = viterbiInit<S>(model, column, prev);
+        if (with_forward) forward_scale.add(forwardInit<S>(model, column, forward_prev), splat(0LL) < lengths);
+        for (int l = 0; l < L; l++) {
+            if (batch.lengths[l] == 1) final_state[l] = argmax<S>(prev, l);
+        }
+
+        // Recursión (t=1 to n-1)
+        for (size_t t = 1; t < n; t++) {
+            Column column(symbols + t * L, model.num_symbols);
+            Mask active = splat((long long)t) < lengths;
+            Vec col_max = viterbiStep<S>(model, prev, column, curr, backptr);
+            log_prob = active ? log_prob + col_max : log_prob;
+            for (int i = 0; i < S; i++) {
+                Bytes packed = __builtin_convertvector(backptr[i], Bytes);
+                std::memcpy(&backptrs[(t * S + i) * L], &packed, L);
+                prev[i] = curr[i];
+            }
+            if (with_forward) {
+                forward_scale.add(forwardStep<S>(model, forward_prev, column, forward_curr), active);
+                for (int i = 0; i < S; i++) forward_prev[i] = forward_curr[i];
+            }
+            for (int l = 0; l < L; l++) {
+                if (batch.lengths[l] == t + 1) final_state[l] = argmax<S>(prev, l);
+            }
+        }
+
+        // Terminación y backtracking de cada carril
+        for (int l = 0; l < L; l++) {
+            if (batch.lengths[l] == 0) continue;
+            int state = final_state[l];
+            for (size_t t = batch.lengths[l] - 1; t > 0; t--) {
+                batch.paths[l][t] = state;
+                state = backptrs[(t * S + state) * L + l];
+            }
+            batch.paths[l][0] = state;
+            *batch.log_probs[l] = log_prob[l];
+            if (with_forward) *batch.forward_log_probs[l] = forward_scale.log(l);
+        }
+
+        // Probabilidades de cada región recalculando las columnas
+        for (size_t t = 0; t < n; t++) {
+            Column column(symbols + t * L, model.num_symbols);
+            if (t == 0) {
+                viterbiInit<S>(model, column, curr);
+            } else {
+                viterbiStep<S>(model, prev, column, curr, backptr);
+            }
+            for (int l = 0; l < L; l++) {
+                if (t >= batch.lengths[l]) continue;
+                double sum_probs = 0.0, best_prob = 0.0;
+                for (int i = 0; i < S; i++) {
+                    double prob = std::exp(curr[i][l]);
+                    sum_probs += prob;
+                    if (i == batch.paths[l][t]) best_prob = prob;
+                }
+                batch.region_probs[l][t] = (sum_probs > 0) ? best_prob / sum_probs : 0.0;
+            }
+            for (int i = 0; i < S; i++) prev[i] = curr[i];
+        }
+    }
+
+    // forwardLogLikelihood de L lecturas
+    template <int S>
+    static HMM_LANE_INLINE void forward(const CompiledModel& model, const LaneBatch& batch,
+                                        std::vector<long long>& symbol_buffer) {
+        Mask lengths;
+        size_t n = interleave(model, batch, symbol_buffer, lengths);
+        const long long* symbols = symbol_buffer.data();
+
+        Vec prev[S], curr[S];
+        Scale scale_acc;
+        scale_acc.add(forwardInit<S>(model, Column(symbols, model.num_symbols), prev), splat(0LL) < lengths);
+        for (size_t t = 1; t < n; t++) {
+            Column column(symbols + t * L, model.num_symbols);
+            scale_acc.add(forwardStep<S>(model, prev, column, curr), splat((long long)t) < lengths);
+            for (int i = 0; i < S; i++) prev[i] = curr[i];
+        }
+        for (int l = 0; l < L; l++) {
+            if (batch.lengths[l] > 0) *batch.log_probs[l] = scale_acc.log(l);
+        }
+    }
+
+    template <int S>
+    static HMM_LANE_INLINE void run(const CompiledModel& model, const LaneBatch& batch, LaneBuffers& buffers,
+                                    bool viterbi_path) {
+        if (viterbi_path) {
+            viterbi<S>(model, batch, buffers.symbols, buffers.backptrs);
+        } else {
+            forward<S>(model, batch, buffers.symbols);
+        }
+    }
+
+    // Elige la instancia según el número de estados; devuelve false si no hay kernel
+    static HMM_LANE_INLINE bool dispatch(const CompiledModel& model, const LaneBatch& batch, LaneBuffers& buffers,
+                                         bool viterbi_path) {
+        if (model.num_symbols > LANE_MAX_SYMBOLS) return false;
+        switch (model.num_states) {
+            case 2: run<2>(model, batch, buffers, viterbi_path); return true;
+            case 4: run<4>(model, batch, buffers, viterbi_path); return true;
+            case 8: run<8>(model, batch, buffers, viterbi_path); return true;
+            default: return false;
+        }
+    }
+};
+
+__attribute__((target("avx512f"))) bool runLanesAvx512(const CompiledModel& model, const LaneBatch& batch,
+                                                       LaneBuffers& buffers, bool viterbi_path) {
+    return Lanes<8>::dispatch(model, batch, buffers, viterbi_path);
+}
+
+__attribute__((target("avx2"))) bool runLanesAvx2(const CompiledModel& model, const LaneBatch& batch,
+                                                  LaneBuffers& buffers, bool viterbi_path) {
+    return Lanes<4>::dispatch(model, batch, buffers, viterbi_path);
+}
+
+#endif  // HMM_SIMD_LANES
+
+// Carriles de la mejor extensión SIMD de la CPU (1 = sin kernel por carriles;
+// con SSE los 2 carriles no compensan el coste de las selecciones)
+int laneWidth() {
+#ifdef HMM_SIMD_LANES
+    static const int width = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return 8;
+        if (__builtin_cpu_supports("avx2")) return 4;
+        return 1;
+    }();
+    return width;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * Ejecuta un grupo de laneWidth() lecturas en el kernel por carriles:
+ * Viterbi (con Forward si batch.forward_log_probs no es NULL) o solo
+ * Forward. Devuelve false si el modelo no tiene kernel por carriles.
+ */
+bool runLanes(const CompiledModel& model, const LaneBatch& batch, LaneBuffers& buffers, bool viterbi_path) {
+#ifdef HMM_SIMD_LANES
+    switch (laneWidth()) {
+        case 8: return runLanesAvx512(model, batch, buffers, viterbi_path);
+        case 4: return runLanesAvx2(model, batch, buffers, viterbi_path);
+    }
+#endif
+    (void)model;
+    (void)batch;
+    (void)buffers;
+    (void)viterbi_path;
+    return false;
+}
+
+/**
+ * Ordena por longitud las lecturas [begin, end) que caben en los kernels
+ * por carriles, para que los carriles de cada grupo terminen casi a la
+ * vez. Las que no caben, y las que no llegan a llenar el último grupo,
+ * quedan en `rest` en su orden original.
+ */
+void laneGroups(const std::vector<size_t>& offsets, size_t begin, size_t end, int width,
+                std::vector<size_t>& grouped, std::vector<size_t>& rest) {
+    grouped.clear();
+    rest.clear();
+    for (size_t r = begin; r < end; r++) {
+        if (width > 1 && offsets[r + 1] - offsets[r] <= LANE_MAX_LENGTH) {
+            grouped.push_back(r);
+        } else {
+            rest.push_back(r);
+        }
+    }
+    std::stable_sort(grouped.begin(), grouped.end(), [&](size_t a, size_t b) {
+        return offsets[a + 1] - offsets[a] < offsets[b + 1] - offsets[b];
+    });
+    size_t full = grouped.size() - grouped.size() % width;
+    rest.insert(rest.end(), grouped.begin() + full, grouped.end());
+    grouped.resize(full);
+    std::sort(rest.begin(), rest.end());
+}
+
+// Longitud mínima de tramo para repartir una secuencia entre hilos
+const size_t PARALLEL_MIN_CHUNK = 1 << 16;
+
+// Longitud máxima de tramo en el entrenamiento; las lecturas más largas se dividen
+const size_t TRAINING_CHUNK = 1 << 16;
+
+// Distancia entre columnas guardadas para detectar la convergencia en Viterbi paralelo
+const size_t PARALLEL_CHECK_INTERVAL = 256;
+
+// Posiciones que procesa StreamingViterbi entre dos búsquedas de coincidencia
+const size_t STREAMING_CHECK_INTERVAL = 1024;
+
+// Mensaje de error de una secuencia con símbolos fuera del alfabeto del modelo
+std::string invalidSequenceMessage(const CompiledModel& model, const std::string& where = "") {
+    return "Secuencia inválida" + where + ". Debe contener solo " + model.alphabet;
+}
+
+/**
+ * Comprueba que dist sea una distribución sobre keys: sin claves
+ * desconocidas, valores en [0, 1] y suma 1 (con tolerancia de redondeo).
+ * Las claves que faltan cuentan como 0.
+ */
+void checkDistribution(const std::map<std::string, double>& dist, const std::vector<std::string>& keys,
+                       const std::string& what) {
+    double sum = 0.0;
+    for (std::map<std::string, double>::const_iterator it = dist.begin(); it != dist.end(); ++it) {
+        if (std::find(keys.begin(), keys.end(), it->first) == keys.end()) {
+            throw std::invalid_argument("Clave desconocida '" + it->first + "' en " + what);
+        }
+        if (!(it->second >= 0.0 && it->second <= 1.0)) {
+            throw std::invalid_argument("Probabilidad fuera de [0, 1] en " + what + " ('" + it->first + "')");
+        }
+        sum += it->second;
+    }
+    if (std::fabs(sum - 1.0) > 1e-6) {
+        throw std::invalid_argument("Las probabilidades de " + what + " no suman 1 (suma = " +
+                                    std::to_string(sum) + ")");
+    }
+}
+
+std::string regionType(const std::string& state) {
+    return (state == "H") ? "Codificante" : "No codificante";
+}
+const char BASE_DECODE[] = "ACGTN";
+
+// Símbolos de una secuencia de texto ya validada
+struct StringSymbols {
+    const short* symbol_index;
+    const char* data;
+
+    StringSymbols(const CompiledModel& model, const std::string& sequence)
+        : symbol_index(model.symbol_index), data(sequence.data()) {}
+
+    StringSymbols(const CompiledModel& model, const char* data)
+        : symbol_index(model.symbol_index), data(data) {}
+
+    int operator[](size_t t) const {
+        return symbol_index[(unsigned char)data[t]];
+    }
+};
+
+// Símbolos leídos directamente de una PackedSequence
+struct PackedSymbols {
+    const uint64_t* words;
+    const uint64_t* n_mask;
+    short code_to_symbol[5];
+
+    int operator[](size_t t) const {
+        int code = (words[t >> 5] >> ((t & 31) * 2)) & 3;
+        if (n_mask && ((n_mask[t >> 6] >> (t & 63)) & 1)) code = 4;
+        return code_to_symbol[code];
+    }
+};
+
+// Bits [bit, bit + count) de un array de palabras (count <= 64)
+inline uint64_t bitField(const uint64_t* words, size_t bit, int count) {
+    size_t w = bit >> 6;
+    int shift = bit & 63;
+    uint64_t value = words[w] >> shift;
+    if (shift + count > 64) value |= words[w + 1] << (64 - shift);
+    return count < 64 ? value & ((uint64_t(1) << count) - 1) : value;
+}
+
+// Símbolos de un k-mer a partir de su índice (2 bits por base)
+struct KmerSymbols {
+    const short* code_to_symbol;
+    size_t kmer;
+
+    int operator[](size_t t) const {
+        return code_to_symbol[(kmer >> (t * 2)) & 3];
+    }
+};
+
+/**
+ * Índice del k-mer que empieza en t, o -1 si contiene alguna N (esas
+ * posiciones se avanzan base a base).
+ */
+inline long kmerAt(const PackedSymbols& symbols, size_t t, int k) {
+    if (symbols.n_mask && bitField(symbols.n_mask, t, k) != 0) return -1;
+    return bitField(symbols.words, t * 2, k * 2);
+}
+
+/**
+ * Forward escalado avanzando k bases por paso con las matrices de
+ * kmers.forward: alpha_{t+k-1} = alpha_{t-1} * M(k-mer) / c.
+ */
+template <int S>
+double forwardKmerKernel(const CompiledModel& model, const KmerTables& kmers, const PackedSymbols& symbols,
+                         size_t n) {
+    const int num_states = stateCount<S>(model);
+    const int k = kmers.k;
+    std::vector<double> columns(2 * num_states);
+    double* prev = &columns[0];
+    double* curr = prev + num_states;
+
+    ScaleAccumulator scale;
+    double log_scale = 0.0;
+    scale.add(forwardInit<S>(model, symbols[0], prev));
+
+    size_t t = 1;
+    for (; k > 0 && t + k <= n; t += k) {
+        long kmer = kmerAt(symbols, t, k);
+        if (kmer < 0) {
+            for (size_t u = t; u < t + k; u++) {
+                scale.add(forwardStep<S>(model, prev, symbols[u], curr));
+                std::swap(prev, curr);
+            }
+            continue;
+        }
+        const double* m = &kmers.forward[kmer * num_states * num_states];
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            double sum = 0.0;
+            HMM_UNROLL_STATES
+            for (int a = 0; a < num_states; a++) {
+                sum += prev[a] * m[a * num_states + i];
+            }
+            curr[i] = sum;
+        }
+        scale.add(scaleColumn<S>(curr, num_states));
+        log_scale += kmers.forward_log_scale[kmer];
+        std::swap(prev, curr);
+    }
+    for (; t < n; t++) {
+        scale.add(forwardStep<S>(model, prev, symbols[t], curr));
+        std::swap(prev, curr);
+    }
+
+    return scale.log() + log_scale;
+}
+
+double forwardKmer(const CompiledModel& model, const KmerTables& kmers, const PackedSymbols& symbols, size_t n) {
+    switch (model.num_states) {
+        case 2: return forwardKmerKernel<2>(model, kmers, symbols, n);
+        case 4: return forwardKmerKernel<4>(model, kmers, symbols, n);
+        case 8: return forwardKmerKernel<8>(model, kmers, symbols, n);
+        default: return forwardKmerKernel<0>(model, kmers, symbols, n);
+    }
+}
+
+/**
+ * Puntuación de Viterbi avanzando k bases por paso con las matrices
+ * (max, +) de kmers.viterbi: delta_{t+k-1}[i] = max_a delta_{t-1}[a] + M[a][i].
+ * Sólo se lleva la columna normalizada y la suma de lo restado.
+ */
+template <int S>
+double viterbiKmerKernel(const CompiledModel& model, const KmerTables& kmers, const PackedSymbols& symbols,
+                         size_t n) {
+    const int num_states = stateCount<S>(model);
+    const int k = kmers.k;
+    std::vector<double> columns(2 * num_states);
+    std::vector<int> backptr(num_states);
+    double* prev = &columns[0];
+    double* curr = prev + num_states;
+
+    double log_prob = viterbiInit<S>(model, symbols[0], prev);
+
+    size_t t = 1;
+    for (; k > 0 && t + k <= n; t += k) {
+        long kmer = kmerAt(symbols, t, k);
+        if (kmer < 0) {
+            for (size_t u = t; u < t + k; u++) {
+                log_prob += viterbiStep<S>(model, prev, symbols[u], curr, &backptr[0]);
+                std::swap(prev, curr);
+            }
+            continue;
+        }
+        const double* m = &kmers.viterbi[kmer * num_states * num_states];
+        HMM_UNROLL_STATES
+        for (int i = 0; i < num_states; i++) {
+            double best = prev[0] + m[i];
+            HMM_UNROLL_STATES
+            for (int a = 1; a < num_states; a++) {
+                best = std::max(best, prev[a] + m[a * num_states + i]);
+            }
+            curr[i] = best;
+        }
+        log_prob += normalizeLogColumn<S>(curr, num_states) + kmers.viterbi_offset[kmer];
+        std::swap(prev, curr);
+    }
+    for (; t < n; t++) {
+        log_prob += viterbiStep<S>(model, prev, symbols[t], curr, &backptr[0]);
+        std::swap(prev, curr);
+    }
+
+    return log_prob;
+}
+
+double viterbiKmer(const CompiledModel& model, const KmerTables& kmers, const PackedSymbols& symbols, size_t n) {
+    switch (model.num_states) {
+        case 2: return viterbiKmerKernel<2>(model, kmers, symbols, n);
+        case 4: return viterbiKmerKernel<4>(model, kmers, symbols, n);
+        case 8: return viterbiKmerKernel<8>(model, kmers, symbols, n);
+        default: return viterbiKmerKernel<0>(model, kmers, symbols, n);
+    }
+}
+
+} // namespace
+
+// Implementaciones de KmerTables
+KmerTables::KmerTables() : k(0) {}
+
+// Implementaciones de ScaleAccumulator
+ScaleAccumulator::ScaleAccumulator() : mantissa(1.0), exponent(0) {}
+
+void ScaleAccumulator::add(double c) {
+    int e;
+    mantissa = std::frexp(mantissa * c, &e);
+    exponent += e;
+}
+
+double ScaleAccumulator::log() const {
+    if (mantissa <= 0.0) return NEG_INF;
+    return std::log(mantissa) + exponent * std::log(2.0);
+}
+
 // Implementaciones de ReconocimientoResult
-ReconocimientoResult::ReconocimientoResult() {}
+ReconocimientoResult::ReconocimientoResult() : log_probabilidad(0.0) {}
+
+ReconocimientoResult::ReconocimientoResult(const std::vector<std::string>& est, const std::vector<double>& prob)
+    : estados(est), probabilidades(prob), log_probabilidad(0.0) {}
+
+ReconocimientoResult::ReconocimientoResult(const std::vector<std::string>& est, const std::vector<double>& prob,
+                                           double log_prob)
+    : estados(est), probabilidades(prob), log_probabilidad(log_prob) {}
+
+// Implementaciones de ForwardEscaladoResult
+ForwardEscaladoResult::ForwardEscaladoResult() : log_probabilidad(0.0) {}
+
+PosteriorResult::PosteriorResult() : log_verosimilitud(0.0) {}
+
+size_t PosteriorResult::size() const {
+    return codigos.size();
+}
+
+double PosteriorResult::posterior(size_t t, int estado) const {
+    if (t >= codigos.size() || estado < 0 || estado >= (int)nombres_estados.size()) {
+        throw std::out_of_range("Posición o estado fuera de rango");
+    }
+    if (posteriores.empty()) {
+        throw std::invalid_argument("El resultado no contiene la matriz de posteriores");
+    }
+    return posteriores[t * nombres_estados.size() + estado];
+}
+
+std::vector<std::string> PosteriorResult::estados() const {
+    std::vector<std::string> labels;
+    labels.reserve(codigos.size());
+    for (size_t t = 0; t < codigos.size(); t++) {
+        labels.push_back(nombres_estados[codigos[t]]);
+    }
+    return labels;
+}
+
+EntrenamientoResult::EntrenamientoResult() : iteraciones(0), convergido(false) {}
+
+// Implementaciones de Region
+Region::Region() : inicio(0), fin(0), longitud(0) {}
+
+Region::Region(int i, int f, const std::string& t, const std::string& s, int l)
+    : inicio(i), fin(f), tipo(t), secuencia(s), longitud(l) {}
+
+// Implementaciones de AnalysisResult
+ReconocimientoCompacto::ReconocimientoCompacto() : log_probabilidad(0.0) {}
+
+size_t ReconocimientoCompacto::size() const {
+    return codigos.size();
+}
+
+std::vector<std::string> ReconocimientoCompacto::estados() const {
+    std::vector<std::string> labels;
+    labels.reserve(codigos.size());
+    for (size_t t = 0; t < codigos.size(); t++) {
+        labels.push_back(nombres_estados[codigos[t]]);
+    }
+    return labels;
+}
+
+std::vector<size_t> ReconocimientoCompacto::tramos() const {
+    std::vector<size_t> bounds;
+    for (size_t t = 0; t < codigos.size(); t++) {
+        if (t == 0 || codigos[t] != codigos[t - 1]) bounds.push_back(t);
+    }
+    bounds.push_back(codigos.size());
+    return bounds;
+}
+
+AnalysisResult::AnalysisResult() : probabilidad_total(0.0), num_regiones_codificantes(0), num_regiones_no_codificantes(0) {}
+
+// Implementaciones de AnalisisCompacto
+RegionCompacta::RegionCompacta() : inicio(0), fin(0), estado(0) {}
+
+RegionCompacta::RegionCompacta(size_t inicio, size_t fin, unsigned char estado)
+    : inicio(inicio), fin(fin), estado(estado) {}
+
+size_t RegionCompacta::longitud() const {
+    return fin - inicio + 1;
+}
+
+AnalisisCompacto::AnalisisCompacto()
+    : log_probabilidad(0.0), probabilidad_total(0.0), datos(NULL), empaquetada(NULL) {}
+
+bool AnalisisCompacto::codificante(size_t i) const {
+    return nombres_estados[regiones.at(i).estado] == "H";
+}
+
+const char* AnalisisCompacto::bases(size_t i) const {
+    return datos ? datos + regiones.at(i).inicio : NULL;
+}
+
+std::string AnalisisCompacto::secuencia(size_t i) const {
+    const RegionCompacta& region = regiones.at(i);
+    if (datos) return std::string(datos + region.inicio, region.longitud());
+
+    std::string sequence;
+    sequence.reserve(region.longitud());
+    for (size_t t = region.inicio; t <= region.fin; t++) {
+        sequence += empaquetada->base(t);
+    }
+    return sequence;
+}
+
+Region AnalisisCompacto::region(size_t i) const {
+    const RegionCompacta& region = regiones.at(i);
+    return Region(region.inicio, region.fin, regionType(nombres_estados[region.estado]), secuencia(i),
+                  region.longitud());
+}
+
+// Implementaciones de los resultados batch
+ReconocimientoBatchResult::ReconocimientoBatchResult() {}
+
+AnalisisBatchResult::AnalisisBatchResult() {}
+
+// Implementaciones de PackedSequence
+PackedSequence::PackedSequence() : num_bases(0) {}
+
+PackedSequence::PackedSequence(const std::string& sequence) : num_bases(0) {
+    append(sequence.data(), sequence.size());
+}
+
+PackedSequence::PackedSequence(const char* data, size_t length) : num_bases(0) {
+    append(data, length);
+}
+
+void PackedSequence::append(const char* data, size_t length) {
+    size_t total = num_bases + length;
+    words.resize((total + 31) / 32, 0);
+    if (!n_mask.empty()) n_mask.resize((total + 63) / 64, 0);
+
+    // Se completa la palabra a medias y después se rellenan palabras enteras
+    unsigned char flags = 0;
+    size_t t = num_bases;
+    while (t < total) {
+        size_t offset = t & 31;
+        size_t count = std::min<size_t>(32 - offset, total - t);
+        const char* bases = data + (t - num_bases);
+        uint64_t word = 0;
+        for (size_t b = 0; b < count; b++) {
+            unsigned char c = BASE_ENCODE.code[(unsigned char)bases[b]];
+            flags |= c;
+            word |= (uint64_t)(c & 3) << (2 * b);
+            if (c & 4) {
+                if (n_mask.empty()) n_mask.assign((total + 63) / 64, 0);
+                n_mask[(t + b) >> 6] |= (uint64_t)1 << ((t + b) & 63);
+            }
+        }
+        words[t >> 5] |= word << (2 * offset);
+        t += count;
+    }
+    num_bases = total;
+
+    if (flags & 0x80) {
+        words.clear();
+        n_mask.clear();
+        num_bases = 0;
+        throw std::invalid_argument("Secuencia inválida. Debe contener solo A, C, G, T o N");
+    }
+}
+
+void PackedSequence::reserve(size_t bases) {
+    words.reserve((bases + 31) / 32);
+}
+
+size_t PackedSequence::size() const {
+    return num_bases;
+}
+
+bool PackedSequence::empty() const {
+    return num_bases == 0;
+}
+
+bool PackedSequence::hasN() const {
+    return !n_mask.empty();
+}
+
+int PackedSequence::code(size_t i) const {
+    if (!n_mask.empty() && ((n_mask[i >> 6] >> (i & 63)) & 1)) return 4;
+    return (words[i >> 5] >> ((i & 31) * 2)) & 3;
+}
+
+char PackedSequence::base(size_t i) const {
+    return BASE_DECODE[code(i)];
+}
+
+std::string PackedSequence::toString() const {
+    std::string result(num_bases, 'A');
+    for (size_t i = 0; i < num_bases; i++) {
+        result[i] = BASE_DECODE[code(i)];
+    }
+    return result;
+}
+
+size_t PackedSequence::memoryBytes() const {
+    return (words.size() + n_mask.size()) * sizeof(uint64_t);
+}
+
+const uint64_t* PackedSequence::wordData() const {
+    return words.data();
+}
+
+const uint64_t* PackedSequence::nMaskData() const {
+    return n_mask.empty() ? NULL : n_mask.data();
+}
+
+// Implementaciones de CompiledModel
+CompiledModel::CompiledModel() : num_states(0), num_symbols(0) {
+    std::fill(symbol_index, symbol_index + 256, -1);
+}
+
+// Implementaciones de HMM_DNA_Analyzer
+HMM_DNA_Analyzer::HMM_DNA_Analyzer() : num_threads(std::max(1u, std::thread::hardware_concurrency())) {
+    states = {"H", "L"};
+    observations = {"A", "C", "G", "T"};
+
+    start_prob["H"] = 0.5;
+    start_prob["L"] = 0.5;
+
+    trans_prob["H"]["H"] = 0.5;
+    trans_prob["H"]["L"] = 0.5;
+    trans_prob["L"]["H"] = 0.4;
+    trans_prob["L"]["L"] = 0.6;
+
+    emit_prob["H"]["A"] = 0.2;
+    emit_prob["H"]["C"] = 0.3;
+    emit_prob["H"]["G"] = 0.3;
+    emit_prob["H"]["T"] = 0.2;
+
+    emit_prob["L"]["A"] = 0.3;
+    emit_prob["L"]["C"] = 0.2;
+    emit_prob["L"]["G"] = 0.2;
+    emit_prob["L"]["T"] = 0.3;
+
+    compileModel();
+}
+
+HMM_DNA_Analyzer::HMM_DNA_Analyzer(const std::vector<std::string>& estados,
+                                   const std::vector<std::string>& observaciones,
+                                   const std::map<std::string, double>& inicio,
+                                   const std::map<std::string, std::map<std::string, double>>& transiciones,
+                                   const std::map<std::string, std::map<std::string, double>>& emisiones)
+    : states(estados), observations(observaciones), start_prob(inicio), trans_prob(transiciones),
+      emit_prob(emisiones), num_threads(std::max(1u, std::thread::hardware_concurrency())) {
+    validateModel();
+    compileModel();
+}
+
+HMM_DNA_Analyzer::HMM_DNA_Analyzer(const std::vector<std::string>& estados,
+                                   const std::vector<std::string>& observaciones,
+                                   const std::vector<double>& inicio, const std::vector<double>& transiciones,
+                                   const std::vector<double>& emisiones)
+    : states(estados), observations(observaciones),
+      num_threads(std::max(1u, std::thread::hardware_concurrency())) {
+    size_t num_states = estados.size();
+    size_t num_symbols = observaciones.size();
+    if (inicio.size() != num_states || transiciones.size() != num_states * num_states ||
+        emisiones.size() != num_states * num_symbols) {
+        throw std::invalid_argument("Tamaños de las tablas incompatibles con el número de estados y símbolos");
+    }
+    for (size_t i = 0; i < num_states; i++) {
+        start_prob[estados[i]] = inicio[i];
+        for (size_t j = 0; j < num_states; j++) {
+            trans_prob[estados[i]][estados[j]] = transiciones[i * num_states + j];
+        }
+        for (size_t k = 0; k < num_symbols; k++) {
+            emit_prob[estados[i]][observaciones[k]] = emisiones[i * num_symbols + k];
+        }
+    }
+    validateModel();
+    compileModel();
+}
+
+void HMM_DNA_Analyzer::validateModel() const {
+    if (states.empty() || states.size() > 256) {
+        throw std::invalid_argument("El modelo debe tener entre 1 y 256 estados");
+    }
+    for (size_t i = 0; i < states.size(); i++) {
+        if (states[i].empty() || std::find(states.begin(), states.begin() + i, states[i]) != states.begin() + i) {
+            throw std::invalid_argument("Nombre de estado vacío o repetido: '" + states[i] + "'");
+        }
+    }
+    if (observations.empty()) {
+        throw std::invalid_argument("El modelo debe tener al menos un símbolo");
+    }
+    for (size_t k = 0; k < observations.size(); k++) {
+        if (observations[k].size() != 1) {
+            throw std::invalid_argument("Cada símbolo debe ser un único carácter: '" + observations[k] + "'");
+        }
+        if (std::find(observations.begin(), observations.begin() + k, observations[k]) != observations.begin() + k) {
+            throw std::invalid_argument("Símbolo repetido: '" + observations[k] + "'");
+        }
+    }
+
+    checkDistribution(start_prob, states, "las probabilidades iniciales");
+    for (std::map<std::string, std::map<std::string, double>>::const_iterator row = trans_prob.begin();
+         row != trans_prob.end(); ++row) {
+        if (std::find(states.begin(), states.end(), row->first) == states.end()) {
+            throw std::invalid_argument("Estado desconocido '" + row->first + "' en las transiciones");
+        }
+    }
+    for (std::map<std::string, std::map<std::string, double>>::const_iterator row = emit_prob.begin();
+         row != emit_prob.end(); ++row) {
+        if (std::find(states.begin(), states.end(), row->first) == states.end()) {
+            throw std::invalid_argument("Estado desconocido '" + row->first + "' en las emisiones");
+        }
+    }
+    for (size_t i = 0; i < states.size(); i++) {
+        std::map<std::string, std::map<std::string, double>>::const_iterator row = trans_prob.find(states[i]);
+        if (row == trans_prob.end()) {
+            throw std::invalid_argument("Faltan las transiciones del estado '" + states[i] + "'");
+        }
+        checkDistribution(row->second, states, "las transiciones del estado '" + states[i] + "'");
+
+        row = emit_prob.find(states[i]);
+        if (row == emit_prob.end()) {
+            throw std::invalid_argument("Faltan las emisiones del estado '" + states[i] + "'");
+        }
+        checkDistribution(row->second, observations, "las emisiones del estado '" + states[i] + "'");
+    }
+}
+
+void HMM_DNA_Analyzer::compileModel() {
+    int num_states = states.size();
+    int num_symbols = observations.size();
+
+    model = CompiledModel();
+    kmers = KmerTables();
+    model.num_states = num_states;
+    model.num_symbols = num_symbols;
+    model.start.assign(num_states, 0.0);
+    model.trans.assign(num_states * num_states, 0.0);
+    model.emit.assign(num_symbols * num_states, 0.0);
+    model.log_start.assign(num_states, NEG_INF);
+    model.log_trans.assign(num_states * num_states, NEG_INF);
+    model.log_emit.assign(num_symbols * num_states, NEG_INF);
+
+    for (int k = 0; k < num_symbols; k++) {
+        unsigned char symbol = observations[k][0];
+        model.symbol_index[symbol] = k;
+        model.alphabet += (k == 0 ? "" : ", ") + observations[k];
+    }
+
+    for (int i = 0; i < num_states; i++) {
+        std::map<std::string, double>::const_iterator it = start_prob.find(states[i]);
+        if (it != start_prob.end()) model.start[i] = it->second;
+
+        std::map<std::string, std::map<std::string, double>>::const_iterator row = trans_prob.find(states[i]);
+        if (row != trans_prob.end()) {
+            for (int j = 0; j < num_states; j++) {
+                it = row->second.find(states[j]);
+                if (it != row->second.end()) model.trans[i * num_states + j] = it->second;
+            }
+        }
+
+        row = emit_prob.find(states[i]);
+        if (row != emit_prob.end()) {
+            for (int k = 0; k < num_symbols; k++) {
+                it = row->second.find(observations[k]);
+                if (it != row->second.end()) model.emit[k * num_states + i] = it->second;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_states; i++) {
+        model.log_start[i] = std::log(model.start[i]);
+    }
+    for (int i = 0; i < num_states * num_states; i++) {
+        model.log_trans[i] = std::log(model.trans[i]);
+    }
+    for (int i = 0; i < num_symbols * num_states; i++) {
+        model.log_emit[i] = std::log(model.emit[i]);
+    }
+}
+
+bool HMM_DNA_Analyzer::validateSequence(const std::string& sequence) const {
+    return validateSequence(sequence.data(), sequence.size());
+}
+
+bool HMM_DNA_Analyzer::validateSequence(const char* data, size_t length) const {
+    if (length == 0) return false;
+    for (size_t t = 0; t < length; t++) {
+        if (model.symbol_index[(unsigned char)data[t]] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HMM_DNA_Analyzer::packedSymbolTable(const PackedSequence& sequence, short* code_to_symbol) const {
+    if (sequence.empty()) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    const char bases[] = "ACGTN";
+    for (int code = 0; code < 5; code++) {
+        code_to_symbol[code] = model.symbol_index[(unsigned char)bases[code]];
+    }
+    for (int code = 0; code < 4; code++) {
+        if (code_to_symbol[code] < 0) {
+            throw std::invalid_argument("El modelo no admite secuencias de nucleótidos empaquetadas");
+        }
+    }
+    if (sequence.hasN() && code_to_symbol[4] < 0) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento(const std::string& sequence) const {
+    return makeReconocimiento(reconocimiento_compacto(sequence));
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento(const PackedSequence& sequence) const {
+    return makeReconocimiento(reconocimiento_compacto(sequence));
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento(const char* datos, size_t longitud) const {
+    return makeReconocimiento(reconocimiento_compacto(datos, longitud));
+}
+
+ReconocimientoCompacto HMM_DNA_Analyzer::reconocimiento_compacto(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return viterbi(StringSymbols(model, sequence), sequence.size());
+}
+
+ReconocimientoCompacto HMM_DNA_Analyzer::reconocimiento_compacto(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return viterbi(symbols, sequence.size());
+}
+
+ReconocimientoCompacto HMM_DNA_Analyzer::reconocimiento_compacto(const char* datos, size_t longitud) const {
+    if (!validateSequence(datos, longitud)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return viterbi(StringSymbols(model, datos), longitud);
+}
+
+template <typename Symbols>
+ReconocimientoCompacto HMM_DNA_Analyzer::viterbi(const Symbols& symbols, size_t n, bool with_probs) const {
+    ViterbiWorkspace ws(model.num_states);
+    std::vector<unsigned char> best_path(n);
+    std::vector<double> region_probs(with_probs ? n : 0);
+    double log_prob = viterbiDecode(model, symbols, n, ws, &best_path[0], with_probs ? &region_probs[0] : NULL);
+    return makeCompacto(best_path, region_probs, log_prob);
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento_checkpoint(const std::string& sequence,
+                                                                 size_t presupuesto_memoria) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return makeReconocimiento(viterbiCheckpoint(StringSymbols(model, sequence), sequence.size(), presupuesto_memoria));
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento_checkpoint(const PackedSequence& sequence,
+                                                                 size_t presupuesto_memoria) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return makeReconocimiento(viterbiCheckpoint(symbols, sequence.size(), presupuesto_memoria));
+}
+
+template <typename Symbols>
+ReconocimientoCompacto HMM_DNA_Analyzer::viterbiCheckpoint(const Symbols& symbols, size_t n,
+                                                         size_t memory_budget) const {
+    int num_states = model.num_states;
+    size_t k = checkpointInterval(n, num_states, memory_budget);
+    size_t num_segments = (n + k - 1) / k;
+
+    // Primera pasada: se guarda la columna en t = c * k y la fila de
+    // punteros que lleva de t - 1 a t (necesaria para cruzar segmentos)
+    std::vector<double> checkpoints(num_segments * num_states);
+    std::vector<int> checkpoint_ptrs(num_segments * num_states, 0);
+    std::vector<double> prev(num_states), curr(num_states);
+    std::vector<int> backptr(num_states);
+
+    double log_prob = viterbiInit(model, symbols[0], &prev[0]);
+    std::copy(prev.begin(), prev.end(), checkpoints.begin());
+
+    for (size_t t = 1; t < n; t++) {
+        log_prob += viterbiStep(model, &prev[0], symbols[t], &curr[0], &backptr[0]);
+        if (t % k == 0) {
+            size_t c = t / k;
+            std::copy(curr.begin(), curr.end(), checkpoints.begin() + c * num_states);
+            std::copy(backptr.begin(), backptr.end(), checkpoint_ptrs.begin() + c * num_states);
+        }
+        prev.swap(curr);
+    }
+
+    std::vector<unsigned char> best_path(n);
+    std::vector<double> region_probs(n);
+    int state = std::max_element(prev.begin(), prev.end()) - prev.begin();
+
+    // Retroceso segmento a segmento, del último al primero, recalculando
+    // las columnas y punteros de cada segmento desde su punto de control
+    std::vector<double> columns(k * num_states);
+    BacktrackStore segment_path(k, num_states);
+
+    for (size_t c = num_segments; c-- > 0;) {
+        size_t begin = c * k;
+        size_t end = std::min(begin + k, n);
+
+        segment_path.clear();
+        std::copy(checkpoints.begin() + c * num_states, checkpoints.begin() + (c + 1) * num_states,
+                  columns.begin());
+        for (size_t t = begin + 1; t < end; t++) {
+            size_t offset = (t - begin) * num_states;
+            viterbiStep(model, &columns[offset - num_states], symbols[t], &columns[offset], &backptr[0]);
+            segment_path.set(t - begin, &backptr[0]);
+        }
+
+        for (size_t t = end; t-- > begin;) {
+            best_path[t] = state;
+
+            const double* column = &columns[(t - begin) * num_states];
+            double sum_probs = 0.0;
+            for (int i = 0; i < num_states; i++) {
+                sum_probs += std::exp(column[i]);
+            }
+            region_probs[t] = (sum_probs > 0) ? std::exp(column[state]) / sum_probs : 0.0;
+
+            if (t > begin) {
+                state = segment_path.get(t - begin, state);
+            } else if (c > 0) {
+                state = checkpoint_ptrs[c * num_states + state];
+            }
+        }
+    }
+
+    return makeCompacto(best_path, region_probs, log_prob);
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento_paralelo(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return makeReconocimiento(viterbiParallel(StringSymbols(model, sequence), sequence.size()));
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::reconocimiento_paralelo(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return makeReconocimiento(viterbiParallel(symbols, sequence.size()));
+}
+
+template <typename Symbols>
+ReconocimientoCompacto HMM_DNA_Analyzer::viterbiParallel(const Symbols& symbols, size_t n, bool with_probs) const {
+    size_t num_chunks = std::min<size_t>(num_threads * 4, n / PARALLEL_MIN_CHUNK);
+    if (num_threads <= 1 || num_chunks <= 1) {
+        return viterbi(symbols, n, with_probs);
+    }
+
+    int num_states = model.num_states;
+
+    // Tramos alineados a 64 posiciones para que ningún par de tramos
+    // comparta una palabra de punteros
+    size_t chunk = ((n + num_chunks - 1) / num_chunks + 63) / 64 * 64;
+    num_chunks = (n + chunk - 1) / chunk;
+
+    BacktrackStore path(n, num_states);
+    std::vector<double> start_cols(num_chunks * num_states);
+    std::vector<double> end_cols(num_chunks * num_states);
+    std::vector<double> offsets(num_chunks, 0.0);
+    std::vector<std::vector<double>> check_cols(num_chunks);
+    std::vector<std::vector<double>> check_offsets(num_chunks);
+
+    // Decodifica un tramo desde la columna de la posición begin - 1 (o
+    // desde la inicialización en el primero), guardando los punteros, la
+    // columna final y cada PARALLEL_CHECK_INTERVAL posiciones una columna
+    auto run_chunk = [&](size_t c) {
+        size_t begin = c * chunk;
+        size_t end = std::min(begin + chunk, n);
+        std::vector<double> prev(num_states), curr(num_states);
+        std::vector<int> backptr(num_states);
+        double offset = 0.0;
+
+        if (c == 0) {
+            offset = viterbiInit(model, symbols[0], &prev[0]);
+            begin = 1;
+        } else {
+            std::copy(&start_cols[c * num_states], &start_cols[(c + 1) * num_states], prev.begin());
+        }
+
+        check_cols[c].clear();
+        check_offsets[c].clear();
+        for (size_t t = begin; t < end; t++) {
+            offset += viterbiStep(model, &prev[0], symbols[t], &curr[0], &backptr[0]);
+            path.set(t, &backptr[0]);
+            prev.swap(curr);
+            if ((t + 1) % PARALLEL_CHECK_INTERVAL == 0) {
+                check_cols[c].insert(check_cols[c].end(), prev.begin(), prev.end());
+                check_offsets[c].push_back(offset);
+            }
+        }
+
+        std::copy(prev.begin(), prev.end(), &end_cols[c * num_states]);
+        offsets[c] = offset;
+    };
+
+    // Fase 1: el primer tramo se decodifica ya; el resto calcula su matriz (max, +)
+    std::vector<std::vector<double>> matrices(num_chunks);
+    parallelFor(num_chunks, num_threads, [&](size_t c, int) {
+        if (c == 0) {
+            run_chunk(0);
+        } else {
+            viterbiTransfer(model, symbols, c * chunk, std::min((c + 1) * chunk, n), matrices[c]);
+        }
+    });
+
+    // Fase 2: columna inicial estimada de cada tramo
+    std::vector<double> column(end_cols.begin(), end_cols.begin() + num_states);
+    std::vector<double> next(num_states);
+    for (size_t c = 1; c < num_chunks; c++) {
+        std::copy(column.begin(), column.end(), &start_cols[c * num_states]);
+        const std::vector<double>& m = matrices[c];
+        for (int i = 0; i < num_states; i++) {
+            double best = column[0] + m[i];
+            for (int a = 1; a < num_states; a++) {
+                best = std::max(best, column[a] + m[a * num_states + i]);
+            }
+            next[i] = best;
+        }
+        normalizeLogColumn(&next[0], num_states);
+        column.swap(next);
+    }
+
+    // Fase 3: decodificación de cada tramo desde la columna estimada
+    parallelFor(num_chunks - 1, num_threads, [&](size_t c, int) {
+        run_chunk(c + 1);
+    });
+
+    // Fase 4: corrección en orden. Si la columna inicial de un tramo no es
+    // exactamente la final del anterior, se repite el tramo desde la exacta
+    // hasta que una columna guardada coincide bit a bit; desde ahí los
+    // punteros calculados en la fase 3 ya son los del algoritmo serie.
+    size_t column_bytes = num_states * sizeof(double);
+    std::vector<double> prev(num_states), curr(num_states);
+    std::vector<int> backptr(num_states);
+    for (size_t c = 1; c < num_chunks; c++) {
+        const double* exact = &end_cols[(c - 1) * num_states];
+        if (std::memcmp(exact, &start_cols[c * num_states], column_bytes) == 0) continue;
+
+        std::copy(exact, exact + num_states, &start_cols[c * num_states]);
+        std::copy(exact, exact + num_states, prev.begin());
+
+        size_t begin = c * chunk;
+        size_t end = std::min(begin + chunk, n);
+        double offset = 0.0;
+        bool converged = false;
+        for (size_t t = begin; t < end && !converged; t++) {
+            offset += viterbiStep(model, &prev[0], symbols[t], &curr[0], &backptr[0]);
+            path.set(t, &backptr[0]);
+            prev.swap(curr);
+            if ((t + 1) % PARALLEL_CHECK_INTERVAL == 0) {
+                size_t k = (t + 1) / PARALLEL_CHECK_INTERVAL - begin / PARALLEL_CHECK_INTERVAL - 1;
+                if (std::memcmp(&prev[0], &check_cols[c][k * num_states], column_bytes) == 0) {
+                    offsets[c] = offset + (offsets[c] - check_offsets[c][k]);
+                    converged = true;
+                }
+            }
+        }
+        if (!converged) {
+            std::copy(prev.begin(), prev.end(), &end_cols[c * num_states]);
+            offsets[c] = offset;
+        }
+    }
+
+    double log_prob = 0.0;
+    for (size_t c = 0; c < num_chunks; c++) {
+        log_prob += offsets[c];
+    }
+
+    // Fase 5: para cada tramo, estado en begin - 1 según el estado final.
+    // Los supervivientes suelen coincidir pronto y a partir de ahí basta
+    // con seguir uno solo.
+    std::vector<unsigned char> entry_states(num_chunks * num_states, 0);
+    parallelFor(num_chunks - 1, num_threads, [&](size_t index, int) {
+        size_t c = index + 1;
+        size_t begin = c * chunk;
+        size_t end = std::min(begin + chunk, n);
+        std::vector<int> survivors(num_states);
+        for (int i = 0; i < num_states; i++) {
+            survivors[i] = i;
+        }
+
+        size_t t = end;
+        bool merged = false;
+        while (t > begin && !merged) {
+            t--;
+            merged = true;
+            for (int i = 0; i < num_states; i++) {
+                survivors[i] = path.get(t, survivors[i]);
+                merged = merged && survivors[i] == survivors[0];
+            }
+        }
+        if (merged) {
+            int state = survivors[0];
+            while (t > begin) {
+                t--;
+                state = path.get(t, state);
+            }
+            survivors.assign(num_states, state);
+        }
+        std::copy(survivors.begin(), survivors.end(), &entry_states[c * num_states]);
+    });
+
+    // Fase 6: estado final de cada tramo, del último al primero
+    const double* last = &end_cols[(num_chunks - 1) * num_states];
+    std::vector<int> end_states(num_chunks);
+    end_states[num_chunks - 1] = std::max_element(last, last + num_states) - last;
+    for (size_t c = num_chunks - 1; c > 0; c--) {
+        end_states[c - 1] = entry_states[c * num_states + end_states[c]];
+    }
+
+    // Fase 7: retroceso y probabilidades de cada tramo en paralelo; las
+    // columnas se recalculan desde la columna inicial exacta del tramo
+    std::vector<unsigned char> best_path(n);
+    std::vector<double> region_probs(with_probs ? n : 0);
+    parallelFor(num_chunks, num_threads, [&](size_t c, int) {
+        size_t begin = c * chunk;
+        size_t end = std::min(begin + chunk, n);
+
+        int state = end_states[c];
+        for (size_t t = end; t-- > begin;) {
+            best_path[t] = state;
+            if (t > 0) state = path.get(t, state);
+        }
+        if (!with_probs) return;
+
+        std::vector<double> prev(num_states), curr(num_states);
+        std::vector<int> backptr(num_states);
+        if (c > 0) {
+            std::copy(&start_cols[c * num_states], &start_cols[(c + 1) * num_states], prev.begin());
+        }
+        for (size_t t = begin; t < end; t++) {
+            if (t == 0) {
+                viterbiInit(model, symbols[0], &curr[0]);
+            } else {
+                viterbiStep(model, &prev[0], symbols[t], &curr[0], &backptr[0]);
+            }
+            double sum_probs = 0.0;
+            for (int i = 0; i < num_states; i++) {
+                sum_probs += std::exp(curr[i]);
+            }
+            region_probs[t] = (sum_probs > 0) ? std::exp(curr[best_path[t]]) / sum_probs : 0.0;
+            prev.swap(curr);
+        }
+    });
+
+    return makeCompacto(best_path, region_probs, log_prob);
+}
+
+ReconocimientoCompacto HMM_DNA_Analyzer::makeCompacto(std::vector<unsigned char>& best_path,
+                                                      std::vector<double>& region_probs,
+                                                      double log_prob) const {
+    ReconocimientoCompacto result;
+    result.nombres_estados = states;
+    result.codigos.swap(best_path);
+    result.probabilidades.swap(region_probs);
+    result.log_probabilidad = log_prob;
+    return result;
+}
+
+ReconocimientoResult HMM_DNA_Analyzer::makeReconocimiento(ReconocimientoCompacto compacto) const {
+    // Convertir índices a nombres de estados
+    ReconocimientoResult result;
+    result.estados = compacto.estados();
+    result.probabilidades.swap(compacto.probabilidades);
+    result.codigos.swap(compacto.codigos);
+    result.log_probabilidad = compacto.log_probabilidad;
+    return result;
+}
+
+void HMM_DNA_Analyzer::reconocimiento_output(const std::string& sequence,
+                          std::vector<std::string>& state_sequence,
+                          std::vector<double>& region_probs) const {
+    ReconocimientoResult result = reconocimiento(sequence);
+    state_sequence = result.estados;
+    region_probs = result.probabilidades;
+}
+
+double HMM_DNA_Analyzer::evaluacion(const std::string& sequence) const {
+    return std::exp(evaluacion_log(sequence));
+}
+
+double HMM_DNA_Analyzer::evaluacion(const PackedSequence& sequence) const {
+    return std::exp(evaluacion_log(sequence));
+}
+
+double HMM_DNA_Analyzer::evaluacion(const char* datos, size_t longitud) const {
+    return std::exp(evaluacion_log(datos, longitud));
+}
+
+double HMM_DNA_Analyzer::evaluacion_log(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardLog(StringSymbols(model, sequence), sequence.size());
+}
+
+double HMM_DNA_Analyzer::evaluacion_log(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return forwardLog(symbols, sequence.size());
+}
+
+double HMM_DNA_Analyzer::evaluacion_log(const char* datos, size_t longitud) const {
+    if (!validateSequence(datos, longitud)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardLog(StringSymbols(model, datos), longitud);
+}
+
+template <typename Symbols>
+double HMM_DNA_Analyzer::forwardLog(const Symbols& symbols, size_t n) const {
+    // Sólo se necesita la columna anterior de la matriz forward
+    std::vector<double> prev(model.num_states), curr(model.num_states);
+    return forwardLogLikelihood(model, symbols, n, &prev[0], &curr[0]);
+}
+
+double HMM_DNA_Analyzer::evaluacion_log_paralela(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardLogParallel(StringSymbols(model, sequence), sequence.size());
+}
+
+double HMM_DNA_Analyzer::evaluacion_log_paralela(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return forwardLogParallel(symbols, sequence.size());
+}
+
+template <typename Symbols>
+double HMM_DNA_Analyzer::forwardLogParallel(const Symbols& symbols, size_t n) const {
+    size_t num_chunks = std::min<size_t>(num_threads * 4, n / PARALLEL_MIN_CHUNK);
+    if (num_threads <= 1 || num_chunks <= 1) {
+        return forwardLog(symbols, n);
+    }
+
+    int num_states = model.num_states;
+    size_t chunk = (n - 1 + num_chunks - 1) / num_chunks;
+
+    // Productos de cada tramo de [1, n) en paralelo
+    std::vector<std::vector<double>> matrices(num_chunks);
+    std::vector<ScaleAccumulator> scales(num_chunks);
+    parallelFor(num_chunks, num_threads, [&](size_t c, int) {
+        size_t begin = 1 + c * chunk;
+        size_t end = std::min(begin + chunk, n);
+        forwardTransfer(model, symbols, begin, end, matrices[c], scales[c]);
+    });
+
+    // Combinación en orden: alpha_{fin} = alpha_0 * M_1 * M_2 * ...
+    std::vector<double> alpha(num_states), next(num_states);
+    ScaleAccumulator scale;
+    scale.add(forwardInit(model, symbols[0], &alpha[0]));
+
+    double log_prob = 0.0;
+    for (size_t c = 0; c < num_chunks; c++) {
+        const std::vector<double>& m = matrices[c];
+        for (int i = 0; i < num_states; i++) {
+            double sum = 0.0;
+            for (int a = 0; a < num_states; a++) {
+                sum += alpha[a] * m[a * num_states + i];
+            }
+            next[i] = sum;
+        }
+        scale.add(scaleColumn(&next[0], num_states));
+        alpha.swap(next);
+        log_prob += scales[c].log();
+    }
+
+    return scale.log() + log_prob;
+}
+
+void HMM_DNA_Analyzer::preparar_kmers(int k) {
+    if (k < 1 || k > 8) {
+        throw std::invalid_argument("La longitud de los k-mers debe estar entre 1 y 8");
+    }
+    short code_to_symbol[4];
+    const char bases[] = "ACGT";
+    for (int code = 0; code < 4; code++) {
+        code_to_symbol[code] = model.symbol_index[(unsigned char)bases[code]];
+        if (code_to_symbol[code] < 0) {
+            throw std::invalid_argument("El modelo no admite secuencias de nucleótidos empaquetadas");
+        }
+    }
+
+    // Cada k-mer es un tramo [0, k) de sus propias bases
+    size_t num_kmers = size_t(1) << (2 * k);
+    size_t matrix_size = model.num_states * model.num_states;
+    KmerTables tables;
+    tables.k = k;
+    tables.forward.resize(num_kmers * matrix_size);
+    tables.forward_log_scale.resize(num_kmers);
+    tables.viterbi.resize(num_kmers * matrix_size);
+    tables.viterbi_offset.resize(num_kmers);
+    parallelFor(num_kmers, num_threads, [&](size_t kmer, int) {
+        KmerSymbols symbols = {code_to_symbol, kmer};
+        std::vector<double> matrix;
+        ScaleAccumulator scale;
+        forwardTransfer(model, symbols, 0, k, matrix, scale);
+        std::copy(matrix.begin(), matrix.end(), &tables.forward[kmer * matrix_size]);
+        tables.forward_log_scale[kmer] = scale.log();
+        tables.viterbi_offset[kmer] = viterbiTransfer(model, symbols, 0, k, matrix);
+        std::copy(matrix.begin(), matrix.end(), &tables.viterbi[kmer * matrix_size]);
+    });
+    std::swap(kmers, tables);
+}
+
+int HMM_DNA_Analyzer::getKmerLength() const {
+    return kmers.k;
+}
+
+double HMM_DNA_Analyzer::evaluacion_log_kmers(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return evaluacion_log_kmers(PackedSequence(sequence));
+}
+
+double HMM_DNA_Analyzer::evaluacion_log_kmers(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return forwardKmer(model, kmers, symbols, sequence.size());
+}
+
+double HMM_DNA_Analyzer::puntuacion_viterbi_kmers(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return puntuacion_viterbi_kmers(PackedSequence(sequence));
+}
+
+double HMM_DNA_Analyzer::puntuacion_viterbi_kmers(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return viterbiKmer(model, kmers, symbols, sequence.size());
+}
+
+ForwardEscaladoResult HMM_DNA_Analyzer::forward_escalado(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardScaled(StringSymbols(model, sequence), sequence.size());
+}
+
+ForwardEscaladoResult HMM_DNA_Analyzer::forward_escalado(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return forwardScaled(symbols, sequence.size());
+}
+
+template <typename Symbols>
+ForwardEscaladoResult HMM_DNA_Analyzer::forwardScaled(const Symbols& symbols, size_t n) const {
+    int num_states = model.num_states;
+
+    ForwardEscaladoResult result;
+    result.coeficientes.resize(n);
+
+    std::vector<double> prev(num_states), curr(num_states);
+
+    result.coeficientes[0] = forwardInit(model, symbols[0], &prev[0]);
+    for (size_t t = 1; t < n; t++) {
+        result.coeficientes[t] = forwardStep(model, &prev[0], symbols[t], &curr[0]);
+        prev.swap(curr);
+    }
+
+    double log_prob = 0.0;
+    for (size_t t = 0; t < n; t++) {
+        log_prob += std::log(result.coeficientes[t]);
+    }
+    result.log_probabilidad = log_prob;
+
+    return result;
+}
+
+PosteriorResult HMM_DNA_Analyzer::decodificacion_posterior(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardBackward(StringSymbols(model, sequence), sequence.size());
+}
+
+PosteriorResult HMM_DNA_Analyzer::decodificacion_posterior(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return forwardBackward(symbols, sequence.size());
+}
+
+PosteriorResult HMM_DNA_Analyzer::decodificacion_posterior(const char* datos, size_t longitud) const {
+    if (!validateSequence(datos, longitud)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardBackward(StringSymbols(model, datos), longitud);
+}
+
+template <typename Symbols>
+PosteriorResult HMM_DNA_Analyzer::forwardBackward(const Symbols& symbols, size_t n) const {
+    int num_states = model.num_states;
+
+    PosteriorResult result;
+    result.nombres_estados = states;
+    result.posteriores.resize(n * num_states);
+    result.codigos.resize(n);
+    result.probabilidades.resize(n);
+
+    // Pasada forward: las columnas escaladas se escriben en la matriz del resultado
+    double* alpha = &result.posteriores[0];
+    std::vector<double> scales(n);
+    ScaleAccumulator scale;
+    scales[0] = forwardInit(model, symbols[0], alpha);
+    scale.add(scales[0]);
+    for (size_t t = 1; t < n; t++) {
+        scales[t] = forwardStep(model, alpha + (t - 1) * num_states, symbols[t], alpha + t * num_states);
+        scale.add(scales[t]);
+    }
+    result.log_verosimilitud = scale.log();
+
+    // Pasada backward: alpha * beta se normaliza en su sitio
+    std::vector<double> beta(num_states, 1.0), prev_beta(num_states), weighted(num_states);
+    for (size_t t = n; t-- > 0;) {
+        double* column = alpha + t * num_states;
+        int best = posteriorColumn(column, &beta[0], num_states, column);
+        result.codigos[t] = best;
+        result.probabilidades[t] = column[best];
+        if (t > 0) {
+            backwardStep(model, &beta[0], symbols[t], scales[t], &weighted[0], &prev_beta[0]);
+            beta.swap(prev_beta);
+        }
+    }
+
+    return result;
+}
+
+PosteriorResult HMM_DNA_Analyzer::decodificacion_posterior_checkpoint(const std::string& sequence,
+                                                                      size_t presupuesto_memoria) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return forwardBackwardCheckpoint(StringSymbols(model, sequence), sequence.size(), presupuesto_memoria);
+}
+
+PosteriorResult HMM_DNA_Analyzer::decodificacion_posterior_checkpoint(const PackedSequence& sequence,
+                                                                      size_t presupuesto_memoria) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return forwardBackwardCheckpoint(symbols, sequence.size(), presupuesto_memoria);
+}
+
+template <typename Symbols>
+PosteriorResult HMM_DNA_Analyzer::forwardBackwardCheckpoint(const Symbols& symbols, size_t n,
+                                                            size_t memory_budget) const {
+    int num_states = model.num_states;
+    size_t k = checkpointInterval(n, num_states, memory_budget);
+    size_t num_segments = (n + k - 1) / k;
+
+    PosteriorResult result;
+    result.nombres_estados = states;
+    result.codigos.resize(n);
+    result.probabilidades.resize(n);
+
+    // Pasada forward: se guarda la columna y el coeficiente en t = c * k
+    std::vector<double> checkpoints(num_segments * num_states);
+    std::vector<double> checkpoint_scales(num_segments);
+    std::vector<double> prev(num_states), curr(num_states);
+    ScaleAccumulator scale;
+
+    checkpoint_scales[0] = forwardInit(model, symbols[0], &prev[0]);
+    scale.add(checkpoint_scales[0]);
+    std::copy(prev.begin(), prev.end(), checkpoints.begin());
+    for (size_t t = 1; t < n; t++) {
+        double c_t = forwardStep(model, &prev[0], symbols[t], &curr[0]);
+        scale.add(c_t);
+        if (t % k == 0) {
+            std::copy(curr.begin(), curr.end(), checkpoints.begin() + (t / k) * num_states);
+            checkpoint_scales[t / k] = c_t;
+        }
+        prev.swap(curr);
+    }
+    result.log_verosimilitud = scale.log();
+
+    // Pasada backward segmento a segmento, recalculando las columnas forward
+    std::vector<double> columns(k * num_states), scales(k);
+    std::vector<double> beta(num_states, 1.0), prev_beta(num_states), weighted(num_states);
+
+    for (size_t c = num_segments; c-- > 0;) {
+        size_t begin = c * k;
+        size_t end = std::min(begin + k, n);
+
+        std::copy(checkpoints.begin() + c * num_states, checkpoints.begin() + (c + 1) * num_states,
+                  columns.begin());
+        scales[0] = checkpoint_scales[c];
+        for (size_t t = begin + 1; t < end; t++) {
+            size_t offset = (t - begin) * num_states;
+            scales[t - begin] = forwardStep(model, &columns[offset - num_states], symbols[t], &columns[offset]);
+        }
+
+        for (size_t t = end; t-- > begin;) {
+            double* column = &columns[(t - begin) * num_states];
+            int best = posteriorColumn(column, &beta[0], num_states, column);
+            result.codigos[t] = best;
+            result.probabilidades[t] = column[best];
+            if (t > 0) {
+                backwardStep(model, &beta[0], symbols[t], scales[t - begin], &weighted[0], &prev_beta[0]);
+                beta.swap(prev_beta);
+            }
+        }
+    }
+
+    return result;
+}
+
+AnalysisResult HMM_DNA_Analyzer::analizar_regiones(const std::string& sequence) const {
+    if (!validateSequence(sequence)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return analyzeFused(StringSymbols(model, sequence), sequence);
+}
+
+AnalysisResult HMM_DNA_Analyzer::analizar_regiones(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    return analyzeFused(symbols, sequence.toString());
+}
 
-ReconocimientoResult::ReconocimientoResult(const std::vector<std::string>& est, const std::vector<double>& prob)
-    : estados(est), probabilidades(prob) {}
+AnalysisResult HMM_DNA_Analyzer::analizar_regiones(const char* datos, size_t longitud) const {
+    if (!validateSequence(datos, longitud)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    return analyzeFused(StringSymbols(model, datos), std::string(datos, longitud));
+}
 
-// Implementaciones de Region
-Region::Region() : inicio(0), fin(0), longitud(0) {}
+template <typename Symbols>
+AnalysisResult HMM_DNA_Analyzer::analyzeFused(const Symbols& symbols, std::string sequence) const {
+    size_t n = sequence.size();
+    ViterbiWorkspace ws(model.num_states);
+    std::vector<unsigned char> best_path(n);
+    std::vector<double> region_probs(n);
+    double forward_log_prob;
+    double log_prob = viterbiDecode(model, symbols, n, ws, &best_path[0], &region_probs[0], &forward_log_prob);
+    return buildAnalysis(std::move(sequence), makeCompacto(best_path, region_probs, log_prob),
+                         std::exp(forward_log_prob));
+}
 
-Region::Region(int i, int f, const std::string& t, const std::string& s, int l)
-    : inicio(i), fin(f), tipo(t), secuencia(s), longitud(l) {}
+AnalisisCompacto HMM_DNA_Analyzer::analizar_regiones_compacto(const std::string& sequence) const {
+    return analizar_regiones_compacto(sequence.data(), sequence.size());
+}
 
-// Implementaciones de AnalysisResult
-AnalysisResult::AnalysisResult() : probabilidad_total(0.0), num_regiones_codificantes(0), num_regiones_no_codificantes(0) {}
+AnalisisCompacto HMM_DNA_Analyzer::analizar_regiones_compacto(const PackedSequence& sequence) const {
+    PackedSymbols symbols;
+    packedSymbolTable(sequence, symbols.code_to_symbol);
+    symbols.words = sequence.wordData();
+    symbols.n_mask = sequence.nMaskData();
+    AnalisisCompacto result = analyzeCompact(symbols, sequence.size());
+    result.empaquetada = &sequence;
+    return result;
+}
 
-// Implementaciones de HMM_DNA_Analyzer
-HMM_DNA_Analyzer::HMM_DNA_Analyzer() {
-    states = {"H", "L"};
-    observations = {"A", "C", "G", "T"};
+AnalisisCompacto HMM_DNA_Analyzer::analizar_regiones_compacto(const char* datos, size_t longitud) const {
+    if (!validateSequence(datos, longitud)) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    AnalisisCompacto result = analyzeCompact(StringSymbols(model, datos), longitud);
+    result.datos = datos;
+    return result;
+}
 
-    start_prob["H"] = 0.5;
-    start_prob["L"] = 0.5;
+template <typename Symbols>
+AnalisisCompacto HMM_DNA_Analyzer::analyzeCompact(const Symbols& symbols, size_t n) const {
+    ViterbiWorkspace ws(model.num_states);
+    AnalisisCompacto result;
+    result.nombres_estados = states;
+    result.codigos.resize(n);
+    result.probabilidades.resize(n);
+    double forward_log_prob;
+    result.log_probabilidad =
+        viterbiDecode(model, symbols, n, ws, &result.codigos[0], &result.probabilidades[0], &forward_log_prob);
+    result.probabilidad_total = std::exp(forward_log_prob);
 
-    trans_prob["H"]["H"] = 0.5;
-    trans_prob["H"]["L"] = 0.5;
-    trans_prob["L"]["H"] = 0.4;
-    trans_prob["L"]["L"] = 0.6;
+    // Tramos de estado constante
+    const std::vector<unsigned char>& codes = result.codigos;
+    size_t begin = 0;
+    for (size_t i = 1; i <= n; i++) {
+        if (i < n && codes[i] == codes[begin]) continue;
+        result.regiones.push_back(RegionCompacta(begin, i - 1, codes[begin]));
+        begin = i;
+    }
+    return result;
+}
 
-    emit_prob["H"]["A"] = 0.2;
-    emit_prob["H"]["C"] = 0.3;
-    emit_prob["H"]["G"] = 0.3;
-    emit_prob["H"]["T"] = 0.2;
+ReconocimientoBatchResult HMM_DNA_Analyzer::reconocimiento_batch(const std::vector<std::string>& secuencias) const {
+    std::vector<const char*> reads;
+    ReconocimientoBatchResult result;
+    collectReads(secuencias, reads, result.offsets);
+    decodeBatch(reads, result.offsets, result.estados, result.probabilidades, result.log_probabilidades, NULL);
+    result.nombres_estados = states;
+    return result;
+}
 
-    emit_prob["L"]["A"] = 0.3;
-    emit_prob["L"]["C"] = 0.2;
-    emit_prob["L"]["G"] = 0.2;
-    emit_prob["L"]["T"] = 0.3;
+ReconocimientoBatchResult HMM_DNA_Analyzer::reconocimiento_batch(const std::string& concatenadas,
+                                                                 const std::vector<size_t>& offsets) const {
+    return reconocimiento_batch(concatenadas.data(), concatenadas.size(), offsets);
 }
 
-bool HMM_DNA_Analyzer::validateSequence(const std::string& sequence) const {
-    if (sequence.empty()) return false;
-    for (char base : sequence) {
-        std::string baseStr(1, base);
-        if (std::find(observations.begin(), observations.end(), baseStr) == observations.end()) {
-            return false;
-        }
-    }
-    return true;
+ReconocimientoBatchResult HMM_DNA_Analyzer::reconocimiento_batch(const char* datos, size_t longitud,
+                                                                 const std::vector<size_t>& offsets) const {
+    std::vector<const char*> reads;
+    collectReads(datos, longitud, offsets, reads);
+    ReconocimientoBatchResult result;
+    result.offsets = offsets;
+    decodeBatch(reads, result.offsets, result.estados, result.probabilidades, result.log_probabilidades, NULL);
+    result.nombres_estados = states;
+    return result;
 }
 
-int HMM_DNA_Analyzer::argmax(const std::vector<double>& vec) const {
-    return std::distance(vec.begin(), std::max_element(vec.begin(), vec.end()));
+std::vector<double> HMM_DNA_Analyzer::evaluacion_batch(const std::vector<std::string>& secuencias) const {
+    std::vector<double> result = evaluacion_log_batch(secuencias);
+    for (size_t r = 0; r < result.size(); r++) {
+        result[r] = std::exp(result[r]);
+    }
+    return result;
 }
 
-ReconocimientoResult HMM_DNA_Analyzer::reconocimiento(const std::string& sequence) {
-    if (!validateSequence(sequence)) {
-        throw std::invalid_argument("Secuencia inválida. Debe contener solo A, C, G, T");
+std::vector<double> HMM_DNA_Analyzer::evaluacion_batch(const std::string& concatenadas,
+                                                       const std::vector<size_t>& offsets) const {
+    std::vector<double> result = evaluacion_log_batch(concatenadas, offsets);
+    for (size_t r = 0; r < result.size(); r++) {
+        result[r] = std::exp(result[r]);
     }
+    return result;
+}
 
-    std::vector<std::string> state_sequence;
-    std::vector<double> region_probs;
+std::vector<double> HMM_DNA_Analyzer::evaluacion_log_batch(const std::vector<std::string>& secuencias) const {
+    std::vector<const char*> reads;
+    std::vector<size_t> offsets;
+    collectReads(secuencias, reads, offsets);
+    return forwardBatch(reads, offsets);
+}
 
-    int n = sequence.length();
-    int num_states = states.size();
+std::vector<double> HMM_DNA_Analyzer::evaluacion_log_batch(const std::string& concatenadas,
+                                                           const std::vector<size_t>& offsets) const {
+    return evaluacion_log_batch(concatenadas.data(), concatenadas.size(), offsets);
+}
 
-    // Inicialización de matrices
-    std::vector<std::vector<double>> V(num_states, std::vector<double>(n, 0.0));
-    std::vector<std::vector<int>> path(num_states, std::vector<int>(n, 0));
+std::vector<double> HMM_DNA_Analyzer::evaluacion_log_batch(const char* datos, size_t longitud,
+                                                           const std::vector<size_t>& offsets) const {
+    std::vector<const char*> reads;
+    collectReads(datos, longitud, offsets, reads);
+    return forwardBatch(reads, offsets);
+}
 
-    // Inicialización (t=0)
-    for (int i = 0; i < num_states; i++) {
-        std::string base(1, sequence[0]);
-        V[i][0] = start_prob[states[i]] * emit_prob[states[i]][base];
-        path[i][0] = 0;
+AnalisisBatchResult HMM_DNA_Analyzer::analizar_regiones_batch(const std::vector<std::string>& secuencias) const {
+    std::vector<const char*> reads;
+    std::vector<size_t> offsets;
+    collectReads(secuencias, reads, offsets);
+    return analyzeBatch(reads, offsets);
+}
+
+AnalisisBatchResult HMM_DNA_Analyzer::analizar_regiones_batch(const std::string& concatenadas,
+                                                              const std::vector<size_t>& offsets) const {
+    return analizar_regiones_batch(concatenadas.data(), concatenadas.size(), offsets);
+}
+
+AnalisisBatchResult HMM_DNA_Analyzer::analizar_regiones_batch(const char* datos, size_t longitud,
+                                                              const std::vector<size_t>& offsets) const {
+    std::vector<const char*> reads;
+    collectReads(datos, longitud, offsets, reads);
+    return analyzeBatch(reads, offsets);
+}
+
+// Comprueba las lecturas [begin, end) de un batch antes de procesarlas
+void HMM_DNA_Analyzer::checkBatchReads(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                                       size_t begin, size_t end) const {
+    for (size_t r = begin; r < end; r++) {
+        if (!validateSequence(reads[r], offsets[r + 1] - offsets[r])) {
+            throw std::invalid_argument(invalidSequenceMessage(model, " en la lectura " + std::to_string(r)));
+        }
     }
+}
 
-    // Recursión (t=1 to n-1)
-    for (int t = 1; t < n; t++) {
-        for (int i = 0; i < num_states; i++) {
-            std::vector<double> probs(num_states);
-            for (int j = 0; j < num_states; j++) {
-                probs[j] = V[j][t-1] * trans_prob[states[j]][states[i]];
+void HMM_DNA_Analyzer::decodeBatch(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                                   std::vector<unsigned char>& path, std::vector<double>& region_probs,
+                                   std::vector<double>& log_probs, std::vector<double>* total_log_probs) const {
+    size_t num_reads = reads.size();
+    path.resize(offsets[num_reads]);
+    region_probs.resize(offsets[num_reads]);
+    log_probs.resize(num_reads);
+    if (total_log_probs) total_log_probs->resize(num_reads);
+
+    std::vector<ViterbiWorkspace> workspaces(num_threads, ViterbiWorkspace(model.num_states));
+    size_t num_blocks = (num_reads + BATCH_BLOCK - 1) / BATCH_BLOCK;
+
+    int width = laneWidth();
+
+    parallelFor(num_blocks, num_threads, [&](size_t block, int thread_id) {
+        ViterbiWorkspace& ws = workspaces[thread_id];
+        size_t begin = block * BATCH_BLOCK;
+        size_t end = std::min(num_reads, (block + 1) * BATCH_BLOCK);
+        checkBatchReads(reads, offsets, begin, end);
+
+        // Grupos de lecturas cortas en carriles SIMD; el resto, una a una
+        std::vector<size_t> grouped, rest;
+        laneGroups(offsets, begin, end, width, grouped, rest);
+        for (size_t g = 0; g < grouped.size(); g += width) {
+            LaneBatch batch;
+            for (int l = 0; l < width; l++) {
+                size_t r = grouped[g + l];
+                batch.reads[l] = reads[r];
+                batch.lengths[l] = offsets[r + 1] - offsets[r];
+                batch.paths[l] = &path[offsets[r]];
+                batch.region_probs[l] = &region_probs[offsets[r]];
+                batch.log_probs[l] = &log_probs[r];
+                batch.forward_log_probs[l] = total_log_probs ? &(*total_log_probs)[r] : NULL;
             }
+            if (!runLanes(model, batch, ws.lanes, true)) {
+                rest.insert(rest.end(), grouped.begin() + g, grouped.end());
+                break;
+            }
+        }
+        for (size_t k = 0; k < rest.size(); k++) {
+            size_t r = rest[k];
+            log_probs[r] = viterbiDecode(model, StringSymbols(model, reads[r]), offsets[r + 1] - offsets[r], ws,
+                                         &path[offsets[r]], &region_probs[offsets[r]],
+                                         total_log_probs ? &(*total_log_probs)[r] : NULL);
+        }
+    });
+}
 
-            int max_prev_state = argmax(probs);
-            double max_prob = probs[max_prev_state];
+std::vector<double> HMM_DNA_Analyzer::forwardBatch(const std::vector<const char*>& reads,
+                                                   const std::vector<size_t>& offsets) const {
+    size_t num_reads = reads.size();
+    std::vector<double> log_probs(num_reads);
+    std::vector<double> columns(num_threads * 2 * model.num_states);
+    std::vector<LaneBuffers> lane_buffers(num_threads);
+    size_t num_blocks = (num_reads + BATCH_BLOCK - 1) / BATCH_BLOCK;
 
-            std::string base(1, sequence[t]);
-            V[i][t] = max_prob * emit_prob[states[i]][base];
-            path[i][t] = max_prev_state;
+    int width = laneWidth();
+
+    parallelFor(num_blocks, num_threads, [&](size_t block, int thread_id) {
+        double* prev = &columns[thread_id * 2 * model.num_states];
+        double* curr = prev + model.num_states;
+        size_t begin = block * BATCH_BLOCK;
+        size_t end = std::min(num_reads, (block + 1) * BATCH_BLOCK);
+        checkBatchReads(reads, offsets, begin, end);
+
+        std::vector<size_t> grouped, rest;
+        laneGroups(offsets, begin, end, width, grouped, rest);
+        for (size_t g = 0; g < grouped.size(); g += width) {
+            LaneBatch batch;
+            for (int l = 0; l < width; l++) {
+                size_t r = grouped[g + l];
+                batch.reads[l] = reads[r];
+                batch.lengths[l] = offsets[r + 1] - offsets[r];
+                batch.log_probs[l] = &log_probs[r];
+            }
+            if (!runLanes(model, batch, lane_buffers[thread_id], false)) {
+                rest.insert(rest.end(), grouped.begin() + g, grouped.end());
+                break;
+            }
         }
+        for (size_t k = 0; k < rest.size(); k++) {
+            size_t r = rest[k];
+            log_probs[r] = forwardLogLikelihood(model, StringSymbols(model, reads[r]), offsets[r + 1] - offsets[r],
+                                                prev, curr);
+        }
+    });
+
+    return log_probs;
+}
+
+AnalisisBatchResult HMM_DNA_Analyzer::analyzeBatch(const std::vector<const char*>& reads,
+                                                   const std::vector<size_t>& offsets) const {
+    AnalisisBatchResult result;
+    size_t num_reads = reads.size();
+    result.nombres_estados = states;
+    result.offsets = offsets;
+    decodeBatch(reads, offsets, result.estados, result.probabilidades, result.log_probabilidades,
+                &result.probabilidades_totales);
+    for (size_t r = 0; r < num_reads; r++) {
+        result.probabilidades_totales[r] = std::exp(result.probabilidades_totales[r]);
     }
 
-    // Terminación - encontrar el mejor camino final
-    std::vector<double> last_probs(num_states);
-    for (int i = 0; i < num_states; i++) {
-        last_probs[i] = V[i][n-1];
+    // Regiones: primero se cuentan por lectura y después se rellenan en su hueco
+    const unsigned char* path = result.estados.data();
+    result.region_offsets.assign(num_reads + 1, 0);
+    size_t num_blocks = (num_reads + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    parallelFor(num_blocks, num_threads, [&](size_t block, int) {
+        size_t end = std::min(num_reads, (block + 1) * BATCH_BLOCK);
+        for (size_t r = block * BATCH_BLOCK; r < end; r++) {
+            size_t count = 1;
+            for (size_t t = offsets[r] + 1; t < offsets[r + 1]; t++) {
+                count += path[t] != path[t - 1];
+            }
+            result.region_offsets[r + 1] = count;
+        }
+    });
+    for (size_t r = 0; r < num_reads; r++) {
+        result.region_offsets[r + 1] += result.region_offsets[r];
     }
-    int best_last_state = argmax(last_probs);
 
-    // Backtracking para reconstruir el mejor camino
-    std::vector<int> best_path(n);
-    best_path[n-1] = best_last_state;
+    size_t num_regions = result.region_offsets[num_reads];
+    result.region_inicio.resize(num_regions);
+    result.region_fin.resize(num_regions);
+    result.region_estado.resize(num_regions);
+    parallelFor(num_blocks, num_threads, [&](size_t block, int) {
+        size_t end = std::min(num_reads, (block + 1) * BATCH_BLOCK);
+        for (size_t r = block * BATCH_BLOCK; r < end; r++) {
+            size_t k = result.region_offsets[r];
+            size_t start = offsets[r];
+            for (size_t t = offsets[r] + 1; t <= offsets[r + 1]; t++) {
+                if (t == offsets[r + 1] || path[t] != path[t - 1]) {
+                    result.region_inicio[k] = start - offsets[r];
+                    result.region_fin[k] = t - 1 - offsets[r];
+                    result.region_estado[k] = path[start];
+                    k++;
+                    start = t;
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+AnalysisResult HMM_DNA_Analyzer::buildAnalysis(std::string sequence, ReconocimientoCompacto reco_result,
+                                               double total_prob) const {
+    AnalysisResult result;
+
+    result.estados_predichos = reco_result.estados();
+    result.probabilidades_posicion = std::move(reco_result.probabilidades);
+    result.probabilidad_total = total_prob;
+    result.secuencia = std::move(sequence);
 
-    for (int t = n - 2; t >= 0; t--) {
-        best_path[t] = path[best_path[t+1]][t+1];
+    // Identificar regiones comparando índices de estado
+    const std::vector<unsigned char>& codes = reco_result.codigos;
+    if (codes.empty()) {
+        return result;
     }
 
-    // Convertir índices a nombres de estados
-    state_sequence.clear();
-    state_sequence.reserve(n);
-    for (int i = 0; i < n; i++) {
-        state_sequence.push_back(states[best_path[i]]);
+    std::vector<std::string> tipos(states.size());
+    for (size_t i = 0; i < states.size(); i++) {
+        tipos[i] = regionType(states[i]);
     }
 
-    // Calcular probabilidades de cada región
-    region_probs.clear();
-    region_probs.reserve(n);
-    for (int t = 0; t < n; t++) {
-        int state_idx = best_path[t];
-        double sum_probs = 0.0;
-        for (int i = 0; i < num_states; i++) {
-            sum_probs += V[i][t];
+    int n = (int)codes.size();
+    int inicio_actual = 0;
+    for (int i = 1; i <= n; i++) {
+        if (i < n && codes[i] == codes[inicio_actual]) continue;
+
+        int estado_actual = codes[inicio_actual];
+        Region region(inicio_actual, i - 1, tipos[estado_actual],
+                      result.secuencia.substr(inicio_actual, i - inicio_actual), i - inicio_actual);
+
+        if (states[estado_actual] == "H") {
+            result.regiones_codificantes.push_back(std::move(region));
+        } else {
+            result.regiones_no_codificantes.push_back(std::move(region));
         }
-        double prob = (sum_probs > 0) ? V[state_idx][t] / sum_probs : 0.0;
-        region_probs.push_back(prob);
+
+        inicio_actual = i;
     }
 
-    return ReconocimientoResult(state_sequence, region_probs);
+    result.num_regiones_codificantes = (int)result.regiones_codificantes.size();
+    result.num_regiones_no_codificantes = (int)result.regiones_no_codificantes.size();
+
+    return result;
 }
 
-void HMM_DNA_Analyzer::reconocimiento_output(const std::string& sequence,
-                          std::vector<std::string>& state_sequence,
-                          std::vector<double>& region_probs) {
-    ReconocimientoResult result = reconocimiento(sequence);
-    state_sequence = result.estados;
-    region_probs = result.probabilidades;
+EntrenamientoResult HMM_DNA_Analyzer::entrenar_baum_welch(const std::vector<std::string>& secuencias,
+                                                          int max_iteraciones, double tolerancia) {
+    std::vector<const char*> reads;
+    std::vector<size_t> offsets;
+    collectReads(secuencias, reads, offsets);
+    return baumWelch(reads, offsets, max_iteraciones, tolerancia);
 }
 
-double HMM_DNA_Analyzer::evaluacion(const std::string& sequence) {
-    if (!validateSequence(sequence)) {
-        throw std::invalid_argument("Secuencia inválida. Debe contener solo A, C, G, T");
-    }
+EntrenamientoResult HMM_DNA_Analyzer::entrenar_baum_welch(const std::string& concatenadas,
+                                                          const std::vector<size_t>& offsets,
+                                                          int max_iteraciones, double tolerancia) {
+    std::vector<const char*> reads;
+    collectReads(concatenadas.data(), concatenadas.size(), offsets, reads);
+    return baumWelch(reads, offsets, max_iteraciones, tolerancia);
+}
 
-    int n = sequence.length();
-    int num_states = states.size();
+EntrenamientoResult HMM_DNA_Analyzer::baumWelch(const std::vector<const char*>& reads,
+                                                const std::vector<size_t>& offsets,
+                                                int max_iterations, double tolerance) {
+    checkTrainingReads(reads, offsets, max_iterations);
+    size_t num_reads = reads.size();
 
-    // Matriz forward
-    std::vector<std::vector<double>> F(num_states, std::vector<double>(n, 0.0));
+    int num_states = model.num_states;
+    size_t num_counts = num_states + num_states * num_states + model.num_symbols * num_states;
 
-    // Inicialización (t=0)
-    for (int i = 0; i < num_states; i++) {
-        std::string base(1, sequence[0]);
-        F[i][0] = start_prob[states[i]] * emit_prob[states[i]][base];
+    // Tareas: bloques de lecturas cortas y tramos de las lecturas largas
+    struct Chunk {
+        size_t read, begin, end;
+    };
+    std::vector<size_t> short_reads, long_reads;
+    std::vector<size_t> long_first_chunk(1, 0);
+    std::vector<Chunk> chunks;
+    for (size_t r = 0; r < num_reads; r++) {
+        size_t n = offsets[r + 1] - offsets[r];
+        if (n <= TRAINING_CHUNK) {
+            short_reads.push_back(r);
+            continue;
+        }
+        long_reads.push_back(r);
+        for (size_t begin = 0; begin < n; begin += TRAINING_CHUNK) {
+            Chunk chunk = {r, begin, std::min(begin + TRAINING_CHUNK, n)};
+            chunks.push_back(chunk);
+        }
+        long_first_chunk.push_back(chunks.size());
     }
+    size_t num_blocks = (short_reads.size() + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    size_t num_tasks = num_blocks + chunks.size();
 
-    // Recursión forward (t=1 to n-1)
-    for (int t = 1; t < n; t++) {
-        for (int i = 0; i < num_states; i++) {
-            F[i][t] = 0.0;
-            for (int j = 0; j < num_states; j++) {
-                F[i][t] += F[j][t-1] * trans_prob[states[j]][states[i]];
+    std::vector<double> task_counts(num_tasks * num_counts);
+    std::vector<double> task_log_probs(num_tasks);
+    std::vector<std::vector<double>> matrices(chunks.size());
+    std::vector<double> alpha_in(chunks.size() * num_states), beta_out(chunks.size() * num_states);
+    std::vector<std::vector<double>> columns(num_threads), scales(num_threads);
+
+    EntrenamientoResult result;
+    double prev_log_prob = 0.0;
+    for (int iteration = 0; iteration < max_iterations; iteration++) {
+        // Columnas de frontera de cada tramo: productos en paralelo y combinación en orden
+        parallelFor(chunks.size(), num_threads, [&](size_t c, int) {
+            ScaleAccumulator unused;
+            forwardTransfer(model, StringSymbols(model, reads[chunks[c].read]), std::max<size_t>(chunks[c].begin, 1),
+                            chunks[c].end, matrices[c], unused);
+        });
+        std::vector<double> column(num_states), next(num_states);
+        for (size_t l = 0; l < long_reads.size(); l++) {
+            size_t first = long_first_chunk[l];
+            size_t last = long_first_chunk[l + 1];
+
+            forwardInit(model, StringSymbols(model, reads[long_reads[l]])[0], &column[0]);
+            for (size_t c = first; c + 1 < last; c++) {
+                for (int i = 0; i < num_states; i++) {
+                    double sum = 0.0;
+                    for (int a = 0; a < num_states; a++) {
+                        sum += column[a] * matrices[c][a * num_states + i];
+                    }
+                    next[i] = sum;
+                }
+                scaleColumn(&next[0], num_states);
+                column.swap(next);
+                std::copy(column.begin(), column.end(), alpha_in.begin() + (c + 1) * num_states);
+            }
+
+            std::fill(column.begin(), column.end(), 1.0);
+            std::copy(column.begin(), column.end(), beta_out.begin() + (last - 1) * num_states);
+            for (size_t c = last - 1; c > first; c--) {
+                for (int a = 0; a < num_states; a++) {
+                    double sum = 0.0;
+                    for (int i = 0; i < num_states; i++) {
+                        sum += matrices[c][a * num_states + i] * column[i];
+                    }
+                    next[a] = sum;
+                }
+                scaleColumn(&next[0], num_states);
+                column.swap(next);
+                std::copy(column.begin(), column.end(), beta_out.begin() + (c - 1) * num_states);
             }
-            std::string base(1, sequence[t]);
-            F[i][t] *= emit_prob[states[i]][base];
         }
-    }
 
-    // Probabilidad total
-    double total_prob = 0.0;
-    for (int i = 0; i < num_states; i++) {
-        total_prob += F[i][n-1];
+        // Conteos esperados de cada tarea en su propio buffer
+        std::fill(task_counts.begin(), task_counts.end(), 0.0);
+        parallelFor(num_tasks, num_threads, [&](size_t task, int thread_id) {
+            double* counts = &task_counts[task * num_counts];
+            if (task < num_blocks) {
+                double log_prob = 0.0;
+                size_t end = std::min(short_reads.size(), (task + 1) * BATCH_BLOCK);
+                for (size_t k = task * BATCH_BLOCK; k < end; k++) {
+                    size_t r = short_reads[k];
+                    log_prob += trainingCounts(model, StringSymbols(model, reads[r]), 0, offsets[r + 1] - offsets[r],
+                                               NULL, NULL, columns[thread_id], scales[thread_id], counts);
+                }
+                task_log_probs[task] = log_prob;
+            } else {
+                size_t c = task - num_blocks;
+                const Chunk& chunk = chunks[c];
+                task_log_probs[task] = trainingCounts(model, StringSymbols(model, reads[chunk.read]), chunk.begin,
+                                                      chunk.end, &alpha_in[c * num_states], &beta_out[c * num_states],
+                                                      columns[thread_id], scales[thread_id], counts);
+            }
+        });
+
+        // Reducción en orden fijo de tareas
+        std::vector<double> counts(num_counts, 0.0);
+        double log_prob = 0.0;
+        for (size_t task = 0; task < num_tasks; task++) {
+            for (size_t k = 0; k < num_counts; k++) {
+                counts[k] += task_counts[task * num_counts + k];
+            }
+            log_prob += task_log_probs[task];
+        }
+
+        result.log_verosimilitudes.push_back(log_prob);
+        result.iteraciones = iteration + 1;
+        setParametersFromCounts(counts);
+
+        if (iteration > 0 && log_prob - prev_log_prob <= tolerance * std::fabs(prev_log_prob)) {
+            result.convergido = true;
+            break;
+        }
+        prev_log_prob = log_prob;
     }
 
-    return total_prob;
+    return result;
 }
 
-AnalysisResult HMM_DNA_Analyzer::analizar_regiones(const std::string& sequence) {
-    AnalysisResult result;
+EntrenamientoResult HMM_DNA_Analyzer::entrenar_viterbi(const std::vector<std::string>& secuencias,
+                                                       int max_iteraciones, double tolerancia, double pseudoconteo) {
+    std::vector<const char*> reads;
+    std::vector<size_t> offsets;
+    collectReads(secuencias, reads, offsets);
+    return viterbiTraining(reads, offsets, max_iteraciones, tolerancia, pseudoconteo);
+}
 
-    ReconocimientoResult reco_result = reconocimiento(sequence);
-    result.estados_predichos = reco_result.estados;
-    result.probabilidades_posicion = reco_result.probabilidades;
-    result.probabilidad_total = evaluacion(sequence);
-    result.secuencia = sequence;
+EntrenamientoResult HMM_DNA_Analyzer::entrenar_viterbi(const std::string& concatenadas,
+                                                       const std::vector<size_t>& offsets,
+                                                       int max_iteraciones, double tolerancia, double pseudoconteo) {
+    std::vector<const char*> reads;
+    collectReads(concatenadas.data(), concatenadas.size(), offsets, reads);
+    return viterbiTraining(reads, offsets, max_iteraciones, tolerancia, pseudoconteo);
+}
 
-    // Identificar regiones
-    if (result.estados_predichos.empty()) {
-        return result;
+EntrenamientoResult HMM_DNA_Analyzer::viterbiTraining(const std::vector<const char*>& reads,
+                                                      const std::vector<size_t>& offsets,
+                                                      int max_iterations, double tolerance, double pseudocount) {
+    checkTrainingReads(reads, offsets, max_iterations);
+    if (!(pseudocount >= 0.0)) {
+        throw std::invalid_argument("El pseudoconteo no puede ser negativo");
     }
+    size_t num_reads = reads.size();
 
-    int inicio_actual = 0;
-    std::string estado_actual = result.estados_predichos[0];
+    int num_states = model.num_states;
+    size_t num_counts = num_states + num_states * num_states + model.num_symbols * num_states;
 
-    for (int i = 1; i < (int)result.estados_predichos.size(); i++) {
-        if (result.estados_predichos[i] != estado_actual) {
-            std::string tipo = (estado_actual == "H") ? "Codificante" : "No codificante";
-            std::string seq_region = sequence.substr(inicio_actual, i - inicio_actual);
+    // Las lecturas cortas se reparten por bloques; las largas usan Viterbi paralelo
+    std::vector<size_t> short_reads, long_reads;
+    for (size_t r = 0; r < num_reads; r++) {
+        (offsets[r + 1] - offsets[r] <= TRAINING_CHUNK ? short_reads : long_reads).push_back(r);
+    }
+    size_t num_blocks = (short_reads.size() + BATCH_BLOCK - 1) / BATCH_BLOCK;
 
-            Region region(inicio_actual, i - 1, tipo, seq_region, i - inicio_actual);
+    std::vector<double> block_counts(num_blocks * num_counts);
+    std::vector<double> block_log_probs(num_blocks);
+    std::vector<ViterbiWorkspace> workspaces(num_threads, ViterbiWorkspace(num_states));
+    std::vector<std::vector<unsigned char>> paths(num_threads);
+    std::vector<double> prev_counts;
 
-            if (estado_actual == "H") {
-                result.regiones_codificantes.push_back(region);
-            } else {
-                result.regiones_no_codificantes.push_back(region);
+    EntrenamientoResult result;
+    double prev_log_prob = 0.0;
+    for (int iteration = 0; iteration < max_iterations; iteration++) {
+        std::fill(block_counts.begin(), block_counts.end(), 0.0);
+        parallelFor(num_blocks, num_threads, [&](size_t block, int thread_id) {
+            double* counts = &block_counts[block * num_counts];
+            std::vector<unsigned char>& path = paths[thread_id];
+            double log_prob = 0.0;
+            size_t end = std::min(short_reads.size(), (block + 1) * BATCH_BLOCK);
+            for (size_t k = block * BATCH_BLOCK; k < end; k++) {
+                size_t r = short_reads[k];
+                size_t n = offsets[r + 1] - offsets[r];
+                StringSymbols symbols(model, reads[r]);
+                path.resize(n);
+                log_prob += viterbiDecode(model, symbols, n, workspaces[thread_id], &path[0], NULL);
+                pathCounts(model, symbols, &path[0], n, counts);
             }
+            block_log_probs[block] = log_prob;
+        });
 
-            inicio_actual = i;
-            estado_actual = result.estados_predichos[i];
+        // Conteos enteros sumados en orden: el resultado no depende del número de hilos
+        std::vector<double> counts(num_counts, 0.0);
+        double log_prob = 0.0;
+        for (size_t block = 0; block < num_blocks; block++) {
+            for (size_t k = 0; k < num_counts; k++) {
+                counts[k] += block_counts[block * num_counts + k];
+            }
+            log_prob += block_log_probs[block];
+        }
+        for (size_t l = 0; l < long_reads.size(); l++) {
+            size_t r = long_reads[l];
+            size_t n = offsets[r + 1] - offsets[r];
+            StringSymbols symbols(model, reads[r]);
+            ReconocimientoCompacto decoded = viterbiParallel(symbols, n, false);
+            pathCounts(model, symbols, &decoded.codigos[0], n, &counts[0]);
+            // La puntuación de Viterbi paralelo depende de los tramos, es decir, de los hilos
+            log_prob += pathLogProb(model, symbols, &decoded.codigos[0], n);
         }
-    }
 
-    // Agregar la última región
-    std::string tipo = (estado_actual == "H") ? "Codificante" : "No codificante";
-    std::string seq_region = sequence.substr(inicio_actual);
+        result.log_verosimilitudes.push_back(log_prob);
+        result.iteraciones = iteration + 1;
 
-    Region region(inicio_actual, (int)result.estados_predichos.size() - 1,
-                 tipo, seq_region, (int)result.estados_predichos.size() - inicio_actual);
+        // Mismos caminos que en la iteración anterior: punto fijo
+        if (counts == prev_counts) {
+            result.convergido = true;
+            break;
+        }
+        prev_counts = counts;
+        for (size_t k = 0; k < num_counts; k++) {
+            counts[k] += pseudocount;
+        }
+        setParametersFromCounts(counts);
 
-    if (estado_actual == "H") {
-        result.regiones_codificantes.push_back(region);
-    } else {
-        result.regiones_no_codificantes.push_back(region);
+        if (iteration > 0 && log_prob - prev_log_prob <= tolerance * std::fabs(prev_log_prob)) {
+            result.convergido = true;
+            break;
+        }
+        prev_log_prob = log_prob;
     }
 
-    result.num_regiones_codificantes = (int)result.regiones_codificantes.size();
-    result.num_regiones_no_codificantes = (int)result.regiones_no_codificantes.size();
-
     return result;
 }
 
+void HMM_DNA_Analyzer::checkTrainingReads(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                                          int max_iterations) const {
+    if (max_iterations < 1) {
+        throw std::invalid_argument("El número de iteraciones debe ser al menos 1");
+    }
+    if (reads.empty()) {
+        throw std::invalid_argument("No hay secuencias de entrenamiento");
+    }
+    for (size_t r = 0; r < reads.size(); r++) {
+        if (!validateSequence(reads[r], offsets[r + 1] - offsets[r])) {
+            throw std::invalid_argument(invalidSequenceMessage(model, " en la lectura " + std::to_string(r)));
+        }
+    }
+}
+
+void HMM_DNA_Analyzer::setParametersFromCounts(const std::vector<double>& counts) {
+    int num_states = model.num_states;
+    int num_symbols = model.num_symbols;
+    const double* start_counts = &counts[0];
+    const double* trans_counts = start_counts + num_states;
+    const double* emit_counts = trans_counts + num_states * num_states;
+
+    double start_total = std::accumulate(start_counts, start_counts + num_states, 0.0);
+    for (int i = 0; i < num_states; i++) {
+        if (start_total > 0.0) start_prob[states[i]] = start_counts[i] / start_total;
+
+        double trans_total = std::accumulate(trans_counts + i * num_states, trans_counts + (i + 1) * num_states, 0.0);
+        if (trans_total > 0.0) {
+            for (int j = 0; j < num_states; j++) {
+                trans_prob[states[i]][states[j]] = trans_counts[i * num_states + j] / trans_total;
+            }
+        }
+
+        double emit_total = 0.0;
+        for (int k = 0; k < num_symbols; k++) {
+            emit_total += emit_counts[k * num_states + i];
+        }
+        if (emit_total > 0.0) {
+            for (int k = 0; k < num_symbols; k++) {
+                emit_prob[states[i]][observations[k]] = emit_counts[k * num_states + i] / emit_total;
+            }
+        }
+    }
+
+    compileModel();
+}
+
 // Métodos getter
 std::vector<std::string> HMM_DNA_Analyzer::getStates() const { 
     return states; 
@@ -252,6 +3299,218 @@ std::map<std::string, std::map<std::string, double>> HMM_DNA_Analyzer::getEmissi
     return emit_prob; 
 }
 
+const CompiledModel& HMM_DNA_Analyzer::getCompiledModel() const {
+    return model;
+}
+
+int HMM_DNA_Analyzer::getNumThreads() const {
+    return num_threads;
+}
+
+void HMM_DNA_Analyzer::setNumThreads(int threads) {
+    if (threads < 1) {
+        throw std::invalid_argument("El número de hilos debe ser al menos 1");
+    }
+    num_threads = threads;
+}
+
+// Implementaciones de StreamingViterbi
+StreamingViterbi::StreamingViterbi(const HMM_DNA_Analyzer& analyzer, size_t max_latencia)
+    : model(analyzer.getCompiledModel()), states(analyzer.getStates()), max_latency(max_latencia),
+      received(0), emitted(0), finished(false), log_prob(0.0), window_offset(0),
+      region_state(-1), region_start(0) {
+    int num_states = model.num_states;
+    prev.resize(num_states);
+    curr.resize(num_states);
+    forward_prev.resize(num_states);
+    forward_curr.resize(num_states);
+    backptr.assign(num_states, 0);
+}
+
+void StreamingViterbi::agregar(const std::string& fragmento) {
+    agregar(fragmento.data(), fragmento.size());
+}
+
+void StreamingViterbi::agregar(const char* datos, size_t longitud) {
+    if (finished) {
+        throw std::logic_error("El decodificador ya fue finalizado");
+    }
+    for (size_t t = 0; t < longitud; t++) {
+        if (model.symbol_index[(unsigned char)datos[t]] < 0) {
+            throw std::invalid_argument(invalidSequenceMessage(model));
+        }
+    }
+
+    for (size_t begin = 0; begin < longitud; begin += STREAMING_CHECK_INTERVAL) {
+        process(datos + begin, std::min(STREAMING_CHECK_INTERVAL, longitud - begin));
+        flush(false);
+    }
+}
+
+void StreamingViterbi::process(const char* data, size_t length) {
+    for (size_t k = 0; k < length; k++) {
+        int symbol = model.symbol_index[(unsigned char)data[k]];
+        if (received == 0) {
+            log_prob = viterbiInit(model, symbol, &prev[0]);
+            forward_scale.add(forwardInit(model, symbol, &forward_prev[0]));
+        } else {
+            log_prob += viterbiStep(model, &prev[0], symbol, &curr[0], &backptr[0]);
+            forward_scale.add(forwardStep(model, &forward_prev[0], symbol, &forward_curr[0]));
+            prev.swap(curr);
+            forward_prev.swap(forward_curr);
+        }
+
+        window_ptrs.insert(window_ptrs.end(), backptr.begin(), backptr.end());
+        window_columns.insert(window_columns.end(), prev.begin(), prev.end());
+        window_bases.push_back(data[k]);
+        received++;
+    }
+}
+
+void StreamingViterbi::flush(bool force) {
+    if (received == emitted) return;
+
+    int num_states = model.num_states;
+    size_t last = received - 1;
+
+    if (force) {
+        emitUntil(last, std::max_element(prev.begin(), prev.end()) - prev.begin());
+        return;
+    }
+
+    // Retroceder desde todos los estados a la vez hasta que coincidan: a
+    // partir de ahí el camino ya no depende de las bases que falten
+    std::vector<int> survivors(num_states);
+    for (int i = 0; i < num_states; i++) {
+        survivors[i] = i;
+    }
+    size_t t = last;
+    bool merged = (num_states == 1);
+    while (!merged && t > emitted) {
+        const unsigned char* ptrs = &window_ptrs[(t - emitted + window_offset) * num_states];
+        merged = true;
+        for (int i = 0; i < num_states; i++) {
+            survivors[i] = ptrs[survivors[i]];
+            merged = merged && survivors[i] == survivors[0];
+        }
+        t--;
+    }
+
+    if (merged) {
+        emitUntil(t, survivors[0]);
+    } else if (max_latency > 0 && received - emitted > max_latency) {
+        // Latencia acotada: se fija la mitad más antigua según el mejor camino actual
+        size_t target = last - max_latency / 2;
+        int state = std::max_element(prev.begin(), prev.end()) - prev.begin();
+        for (t = last; t > target; t--) {
+            state = window_ptrs[(t - emitted + window_offset) * num_states + state];
+        }
+        emitUntil(target, state);
+    }
+}
+
+void StreamingViterbi::emitUntil(size_t last, int state) {
+    int num_states = model.num_states;
+    size_t count = last - emitted + 1;
+
+    std::vector<unsigned char> path(count);
+    for (size_t k = count; k-- > 0;) {
+        path[k] = state;
+        if (k > 0) state = window_ptrs[(k + window_offset) * num_states + state];
+    }
+
+    for (size_t k = 0; k < count; k++) {
+        size_t t = emitted + k;
+        int s = path[k];
+
+        const double* column = &window_columns[(k + window_offset) * num_states];
+        double sum_probs = 0.0;
+        for (int i = 0; i < num_states; i++) {
+            sum_probs += std::exp(column[i]);
+        }
+        out_states.push_back(s);
+        out_probs.push_back((sum_probs > 0) ? std::exp(column[s]) / sum_probs : 0.0);
+
+        if (region_state >= 0 && s != region_state) {
+            closeRegion(t);
+        }
+        if (region_state < 0) {
+            region_state = s;
+            region_start = t;
+        }
+        region_bases.push_back(window_bases[k + window_offset]);
+    }
+
+    emitted += count;
+    window_offset += count;
+
+    // Descartar la parte ya publicada de la ventana cuando ocupa la mitad
+    if (window_offset >= STREAMING_CHECK_INTERVAL && window_offset * 2 >= window_bases.size()) {
+        window_ptrs.erase(window_ptrs.begin(), window_ptrs.begin() + window_offset * num_states);
+        window_columns.erase(window_columns.begin(), window_columns.begin() + window_offset * num_states);
+        window_bases.erase(0, window_offset);
+        window_offset = 0;
+    }
+}
+
+void StreamingViterbi::closeRegion(size_t end) {
+    if (region_state < 0) return;
+
+    const std::string& state = states[region_state];
+    out_regions.push_back(Region(region_start, end - 1, regionType(state), region_bases, end - region_start));
+    region_bases.clear();
+    region_state = -1;
+}
+
+void StreamingViterbi::finalizar() {
+    if (finished) return;
+    if (received == 0) {
+        throw std::invalid_argument(invalidSequenceMessage(model));
+    }
+    flush(true);
+    closeRegion(received);
+    finished = true;
+}
+
+ReconocimientoResult StreamingViterbi::tomar_estados() {
+    std::vector<std::string> state_sequence;
+    state_sequence.reserve(out_states.size());
+    for (size_t i = 0; i < out_states.size(); i++) {
+        state_sequence.push_back(states[out_states[i]]);
+    }
+
+    ReconocimientoResult result(state_sequence, out_probs, log_prob);
+    result.codigos.swap(out_states);
+    out_probs.clear();
+    return result;
+}
+
+std::vector<Region> StreamingViterbi::tomar_regiones() {
+    std::vector<Region> result;
+    result.swap(out_regions);
+    return result;
+}
+
+size_t StreamingViterbi::posiciones_recibidas() const {
+    return received;
+}
+
+size_t StreamingViterbi::posiciones_finalizadas() const {
+    return emitted;
+}
+
+size_t StreamingViterbi::posiciones_pendientes() const {
+    return received - emitted;
+}
+
+double StreamingViterbi::log_probabilidad() const {
+    return log_prob;
+}
+
+double StreamingViterbi::log_verosimilitud() const {
+    return forward_scale.log();
+}
+
 // Funciones globales
 ReconocimientoResult reconocimiento_global(const std::string& sequence) {
     HMM_DNA_Analyzer analyzer;
@@ -268,4 +3527,9 @@ void reconocimiento_global_output(const std::string& sequence,
 double evaluacion_global(const std::string& sequence) {
     HMM_DNA_Analyzer analyzer;
     return analyzer.evaluacion(sequence);
+}
+
+double evaluacion_log_global(const std::string& sequence) {
+    HMM_DNA_Analyzer analyzer;
+    return analyzer.evaluacion_log(sequence);
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include <numeric>
 #include <stdexcept>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 /**
  * @brief Estructura para el resultado del reconocimiento
@@ -16,9 +18,76 @@
 struct ReconocimientoResult {
     std::vector<std::string> estados;
     std::vector<double> probabilidades;
+    std::vector<unsigned char> codigos;  // índice de estado por posición (en getStates())
+    double log_probabilidad;  // log P del mejor camino
 
     ReconocimientoResult();
     ReconocimientoResult(const std::vector<std::string>& est, const std::vector<double>& prob);
+    ReconocimientoResult(const std::vector<std::string>& est, const std::vector<double>& prob, double log_prob);
+};
+
+/**
+ * @brief Resultado de reconocimiento con los estados como índices
+ *
+ * codigos[t] es el índice del estado en nombres_estados: 1 byte por base
+ * en lugar de un std::string. Las etiquetas solo se generan si se piden
+ * con estados(); tramos() da el camino codificado por tramos.
+ */
+struct ReconocimientoCompacto {
+    std::vector<std::string> nombres_estados;
+    std::vector<unsigned char> codigos;
+    std::vector<double> probabilidades;
+    double log_probabilidad;  // log P del mejor camino
+
+    ReconocimientoCompacto();
+
+    size_t size() const;
+    /**
+     * @brief Etiqueta de estado de cada posición (como ReconocimientoResult::estados)
+     */
+    std::vector<std::string> estados() const;
+    /**
+     * @brief Límites de los tramos de estado constante
+     *
+     * El tramo k ocupa [tramos[k], tramos[k+1]) con estado codigos[tramos[k]];
+     * el último elemento es size().
+     */
+    std::vector<size_t> tramos() const;
+};
+
+/**
+ * @brief Resultado del algoritmo Forward escalado
+ *
+ * coeficientes[t] es el factor c_t con el que se normalizó la columna t,
+ * de modo que log P(secuencia) = sum_t log(c_t).
+ */
+struct ForwardEscaladoResult {
+    double log_probabilidad;
+    std::vector<double> coeficientes;
+
+    ForwardEscaladoResult();
+};
+
+/**
+ * @brief Resultado de la decodificación posterior (Forward-Backward)
+ *
+ * posteriores[t * nombres_estados.size() + i] = P(estado_t = i | secuencia).
+ * codigos[t] es el estado de mayor posterior en la posición t y
+ * probabilidades[t] su posterior. La variante con puntos de control deja
+ * posteriores vacío.
+ */
+struct PosteriorResult {
+    std::vector<std::string> nombres_estados;
+    std::vector<double> posteriores;
+    std::vector<unsigned char> codigos;
+    std::vector<double> probabilidades;
+    double log_verosimilitud;  // log P(secuencia)
+
+    PosteriorResult();
+
+    size_t size() const;
+    double posterior(size_t t, int estado) const;
+    std::vector<std::string> estados() const;
 };
 
 /**
@@ -51,6 +120,231 @@ struct AnalysisResult {
     AnalysisResult();
 };
 
+/**
+ * @brief Resultado de reconocimiento_batch como estructura de arrays
+ *
+ * Las posiciones de la lectura r ocupan [offsets[r], offsets[r+1]) en
+ * estados (índice en nombres_estados) y probabilidades.
+ */
+struct ReconocimientoBatchResult {
+    std::vector<std::string> nombres_estados;
+    std::vector<size_t> offsets;
+    std::vector<unsigned char> estados;
+    std::vector<double> probabilidades;
+    std::vector<double> log_probabilidades;
+
+    ReconocimientoBatchResult();
+};
+
+/**
+ * @brief Resultado de analizar_regiones_batch como estructura de arrays
+ *
+ * Además de los arrays de reconocimiento, las regiones de la lectura r
+ * ocupan [region_offsets[r], region_offsets[r+1]) en region_inicio,
+ * region_fin y region_estado (posiciones relativas a la lectura).
+ */
+struct AnalisisBatchResult {
+    std::vector<std::string> nombres_estados;
+    std::vector<size_t> offsets;
+    std::vector<unsigned char> estados;
+    std::vector<double> probabilidades;
+    std::vector<double> log_probabilidades;
+    std::vector<double> probabilidades_totales;
+    std::vector<size_t> region_offsets;
+    std::vector<int> region_inicio;
+    std::vector<int> region_fin;
+    std::vector<unsigned char> region_estado;
+
+    AnalisisBatchResult();
+};
+
+/**
+ * @brief Resultado del entrenamiento de los parámetros del modelo
+ *
+ * log_verosimilitudes[i] es la log-verosimilitud del corpus con los
+ * parámetros al empezar la iteración i (en entrenar_viterbi, la suma de
+ * log P del mejor camino de cada lectura).
+ */
+struct EntrenamientoResult {
+    std::vector<double> log_verosimilitudes;
+    int iteraciones;
+    bool convergido;
+
+    EntrenamientoResult();
+};
+
+/**
+ * @brief Secuencia de nucleótidos empaquetada a 2 bits por base
+ *
+ * A, C, G y T se codifican como 0..3, 32 bases por palabra de 64 bits.
+ * Las N se marcan en un bitmap aparte que sólo se reserva si la secuencia
+ * contiene alguna. Se aceptan mayúsculas y minúsculas. La secuencia se
+ * valida una sola vez al construirla y puede reutilizarse en varios
+ * análisis sin volver a validarla.
+ */
+class PackedSequence {
+private:
+    std::vector<uint64_t> words;
+    std::vector<uint64_t> n_mask;
+    size_t num_bases;
+
+public:
+    PackedSequence();
+    PackedSequence(const std::string& sequence);
+    PackedSequence(const char* data, size_t length);
+
+    /**
+     * @brief Añade bases al final (p. ej. las líneas de un registro FASTA)
+     *
+     * Si aparece un carácter que no es A, C, G, T o N lanza
+     * std::invalid_argument y la secuencia queda vacía.
+     */
+    void append(const char* data, size_t length);
+
+    /**
+     * @brief Reserva memoria para `bases` bases en total
+     */
+    void reserve(size_t bases);
+
+    size_t size() const;
+    bool empty() const;
+    bool hasN() const;
+
+    /**
+     * @brief Código de la base i: 0=A, 1=C, 2=G, 3=T, 4=N
+     */
+    int code(size_t i) const;
+    char base(size_t i) const;
+    std::string toString() const;
+
+    /**
+     * @brief Bytes ocupados por las palabras empaquetadas y el bitmap de N
+     */
+    size_t memoryBytes() const;
+
+    // Acceso directo para los algoritmos; nMaskData() es NULL si no hay N
+    const uint64_t* wordData() const;
+    const uint64_t* nMaskData() const;
+};
+
+/**
+ * @brief Región de analizar_regiones_compacto(): sólo posiciones y estado
+ *
+ * [inicio, fin] incluye fin, como en Region; estado es el índice en
+ * AnalisisCompacto::nombres_estados.
+ */
+struct RegionCompacta {
+    size_t inicio;
+    size_t fin;
+    unsigned char estado;
+
+    RegionCompacta();
+    RegionCompacta(size_t inicio, size_t fin, unsigned char estado);
+    size_t longitud() const;
+};
+
+/**
+ * @brief Resultado de analizar_regiones_compacto()
+ *
+ * Mismos estados, probabilidades y regiones que AnalysisResult, pero sin
+ * copiar la secuencia: las regiones (codificantes y no codificantes, en
+ * orden) son posiciones y sus bases se leen de la secuencia del llamador,
+ * que debe seguir viva mientras se usen bases(), secuencia() o region().
+ * Los strings sólo se crean al pedirlos.
+ */
+struct AnalisisCompacto {
+    std::vector<std::string> nombres_estados;
+    std::vector<unsigned char> codigos;
+    std::vector<double> probabilidades;
+    double log_probabilidad;    // log P del mejor camino
+    double probabilidad_total;  // P(secuencia), como AnalysisResult::probabilidad_total
+    std::vector<RegionCompacta> regiones;
+    const char* datos;                  // texto analizado, o NULL
+    const PackedSequence* empaquetada;  // secuencia empaquetada analizada, o NULL
+
+    AnalisisCompacto();
+
+    /**
+     * @brief La región i es codificante (su estado se llama "H")
+     */
+    bool codificante(size_t i) const;
+    /**
+     * @brief Puntero a las bases de la región i dentro del texto del
+     * llamador (NULL si se analizó una PackedSequence)
+     */
+    const char* bases(size_t i) const;
+    /**
+     * @brief Copia de las bases de la región i
+     */
+    std::string secuencia(size_t i) const;
+    /**
+     * @brief La región i como Region (con su copia de las bases)
+     */
+    Region region(size_t i) const;
+};
+
+/**
+ * @brief Representación compacta del modelo usada por los algoritmos
+ *
+ * Los estados y símbolos se indexan por posición en `states` y
+ * `observations`. Las matrices se guardan contiguas:
+ *  - trans[j * num_states + i] = P(i | j)
+ *  - emit[k * num_states + i]  = P(símbolo k | estado i)
+ * log_start, log_trans y log_emit guardan los logaritmos con la misma
+ * disposición. symbol_index traduce cada byte de la secuencia a su índice de símbolo
+ * (-1 si el byte no pertenece al alfabeto). alphabet es la lista de
+ * símbolos para los mensajes de error ("A, C, G, T").
+ */
+struct CompiledModel {
+    int num_states;
+    int num_symbols;
+    std::string alphabet;
+    std::vector<double> start;
+    std::vector<double> trans;
+    std::vector<double> emit;
+    std::vector<double> log_start;
+    std::vector<double> log_trans;
+    std::vector<double> log_emit;
+    short symbol_index[256];
+
+    CompiledModel();
+};
+
+/**
+ * @brief Producto de coeficientes de escala guardado como mantisa y
+ * exponente binario, para no pagar un log() por cada posición
+ */
+struct ScaleAccumulator {
+    double mantissa;
+    long exponent;
+
+    ScaleAccumulator();
+    void add(double c);
+    double log() const;
+};
+
+/**
+ * @brief Matrices de transferencia precalculadas de los 4^k k-mers
+ *
+ * El índice de un k-mer son los códigos de 2 bits de sus bases, la primera
+ * en los bits bajos (el mismo orden que en PackedSequence). Para cada
+ * k-mer se guarda, con la fila como estado de partida:
+ *  - forward: producto de las k matrices P(i|j) * P(base|i), normalizado
+ *    para que sume 1, y en forward_log_scale el log del factor quitado
+ *  - viterbi: el mismo producto en el semianillo (max, +) sobre los
+ *    logaritmos, con máximo 0, y en viterbi_offset lo restado
+ * k = 0 indica que no hay tablas.
+ */
+struct KmerTables {
+    int k;
+    std::vector<double> forward;
+    std::vector<double> forward_log_scale;
+    std::vector<double> viterbi;
+    std::vector<double> viterbi_offset;
+
+    KmerTables();
+};
+
 /**
  * @brief Analizador de secuencias de ADN usando Hidden Markov Models
  */
@@ -61,36 +355,348 @@ private:
     std::map<std::string, double> start_prob;
     std::map<std::string, std::map<std::string, double>> trans_prob;
     std::map<std::string, std::map<std::string, double>> emit_prob;
+    CompiledModel model;
+    KmerTables kmers;
+    int num_threads;
 
+    void compileModel();
+    void validateModel() const;
     bool validateSequence(const std::string& sequence) const;
-    int argmax(const std::vector<double>& vec) const;
+    bool validateSequence(const char* data, size_t length) const;
+    void packedSymbolTable(const PackedSequence& sequence, short* code_to_symbol) const;
+
+    template <typename Symbols>
+    ReconocimientoCompacto viterbi(const Symbols& symbols, size_t n, bool with_probs = true) const;
+    template <typename Symbols>
+    ReconocimientoCompacto viterbiCheckpoint(const Symbols& symbols, size_t n, size_t memory_budget) const;
+    template <typename Symbols>
+    ReconocimientoCompacto viterbiParallel(const Symbols& symbols, size_t n, bool with_probs = true) const;
+    ReconocimientoCompacto makeCompacto(std::vector<unsigned char>& best_path,
+                                        std::vector<double>& region_probs, double log_prob) const;
+    ReconocimientoResult makeReconocimiento(ReconocimientoCompacto compacto) const;
+    template <typename Symbols>
+    double forwardLog(const Symbols& symbols, size_t n) const;
+    template <typename Symbols>
+    double forwardLogParallel(const Symbols& symbols, size_t n) const;
+    template <typename Symbols>
+    ForwardEscaladoResult forwardScaled(const Symbols& symbols, size_t n) const;
+    template <typename Symbols>
+    PosteriorResult forwardBackward(const Symbols& symbols, size_t n) const;
+    template <typename Symbols>
+    PosteriorResult forwardBackwardCheckpoint(const Symbols& symbols, size_t n, size_t memory_budget) const;
+    void checkBatchReads(const std::vector<const char*>& reads, const std::vector<size_t>& offsets, size_t begin,
+                         size_t end) const;
+    void decodeBatch(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                     std::vector<unsigned char>& path, std::vector<double>& region_probs,
+                     std::vector<double>& log_probs, std::vector<double>* total_log_probs) const;
+    std::vector<double> forwardBatch(const std::vector<const char*>& reads,
+                                     const std::vector<size_t>& offsets) const;
+    AnalisisBatchResult analyzeBatch(const std::vector<const char*>& reads,
+                                     const std::vector<size_t>& offsets) const;
+    template <typename Symbols>
+    AnalysisResult analyzeFused(const Symbols& symbols, std::string sequence) const;
+    template <typename Symbols>
+    AnalisisCompacto analyzeCompact(const Symbols& symbols, size_t n) const;
+    AnalysisResult buildAnalysis(std::string sequence, ReconocimientoCompacto reco, double total_prob) const;
+    EntrenamientoResult baumWelch(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                                  int max_iterations, double tolerance);
+    EntrenamientoResult viterbiTraining(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                                        int max_iterations, double tolerance, double pseudocount);
+    void checkTrainingReads(const std::vector<const char*>& reads, const std::vector<size_t>& offsets,
+                            int max_iterations) const;
+    void setParametersFromCounts(const std::vector<double>& counts);
 
 public:
+    /**
+     * @brief Modelo por defecto de dos estados (H codificante, L no
+     * codificante) sobre el alfabeto A, C, G, T
+     */
     HMM_DNA_Analyzer();
 
+    /**
+     * @brief Modelo arbitrario de N estados y M símbolos
+     *
+     * Las tablas usan los nombres de estados y símbolos como claves, igual
+     * que los getters. Cada símbolo es un único carácter y puede haber hasta
+     * 256 estados. Se comprueba que las probabilidades estén en [0, 1], que
+     * cada distribución sume 1 y que no haya claves desconocidas; si no,
+     * lanza std::invalid_argument. Las regiones se clasifican como
+     * codificantes si el estado se llama "H".
+     */
+    HMM_DNA_Analyzer(const std::vector<std::string>& estados, const std::vector<std::string>& observaciones,
+                     const std::map<std::string, double>& inicio,
+                     const std::map<std::string, std::map<std::string, double>>& transiciones,
+                     const std::map<std::string, std::map<std::string, double>>& emisiones);
+
+    /**
+     * @brief Modelo arbitrario a partir de arrays
+     *
+     * inicio[i] = P(estado i al inicio), transiciones[i * N + j] = P(j | i) y
+     * emisiones[i * M + k] = P(símbolo k | estado i).
+     */
+    HMM_DNA_Analyzer(const std::vector<std::string>& estados, const std::vector<std::string>& observaciones,
+                     const std::vector<double>& inicio, const std::vector<double>& transiciones,
+                     const std::vector<double>& emisiones);
+
     /**
      * @brief Función de reconocimiento usando algoritmo de Viterbi
+     *
+     * Se calcula en espacio logarítmico, por lo que no hay underflow en
+     * secuencias largas.
      * @param sequence Secuencia de ADN
      * @return ReconocimientoResult con estados y probabilidades
      */
-    ReconocimientoResult reconocimiento(const std::string& sequence);
+    ReconocimientoResult reconocimiento(const std::string& sequence) const;
+    ReconocimientoResult reconocimiento(const PackedSequence& sequence) const;
+    ReconocimientoResult reconocimiento(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief reconocimiento() sin generar un std::string por posición
+     *
+     * Mismo camino y probabilidades que reconocimiento(), con los estados
+     * como índices de 1 byte.
+     */
+    ReconocimientoCompacto reconocimiento_compacto(const std::string& sequence) const;
+    ReconocimientoCompacto reconocimiento_compacto(const PackedSequence& sequence) const;
+    ReconocimientoCompacto reconocimiento_compacto(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief Viterbi con puntos de control para secuencias muy largas
+     *
+     * Guarda la columna de Viterbi cada k posiciones y recalcula cada
+     * segmento durante el retroceso, con una pasada extra sobre la
+     * secuencia. La memoria de trabajo es O(n/k + k) en lugar de O(n).
+     * El resultado es idéntico al de reconocimiento().
+     * @param presupuesto_memoria Bytes de memoria de trabajo permitidos
+     *        (sin contar el resultado). Se elige el k más grande que cabe en
+     *        el presupuesto; con 0, o si no cabe ningún k, se usa k ~ sqrt(n).
+     */
+    ReconocimientoResult reconocimiento_checkpoint(const std::string& sequence,
+                                                   size_t presupuesto_memoria = 0) const;
+    ReconocimientoResult reconocimiento_checkpoint(const PackedSequence& sequence,
+                                                   size_t presupuesto_memoria = 0) const;
+
+    /**
+     * @brief Viterbi repartido entre getNumThreads() hilos
+     *
+     * La recursión de Viterbi es asociativa en el semianillo (max, +): se
+     * calculan en paralelo las matrices de transferencia de cada tramo, se
+     * combinan para estimar la columna inicial de cada tramo y cada tramo
+     * se decodifica en paralelo. Después se corrige en orden cada tramo
+     * desde la columna exacta hasta que coincide bit a bit con la calculada,
+     * por lo que el camino es idéntico al de reconocimiento(), incluidos
+     * los empates. El retroceso y las probabilidades también se calculan
+     * por tramos en paralelo. Solo el camino y las probabilidades son
+     * idénticos bit a bit: log_probabilidad suma los términos de cada tramo
+     * por separado y difiere de la de reconocimiento() en el redondeo de
+     * la suma, que crece con la longitud (del orden de 1e-11 en relativo
+     * para 3 millones de bases).
+     */
+    ReconocimientoResult reconocimiento_paralelo(const std::string& sequence) const;
+    ReconocimientoResult reconocimiento_paralelo(const PackedSequence& sequence) const;
 
     /**
      * @brief Función de reconocimiento con parámetros de salida
      */
     void reconocimiento_output(const std::string& sequence,
                               std::vector<std::string>& state_sequence,
-                              std::vector<double>& region_probs);
+                              std::vector<double>& region_probs) const;
 
     /**
      * @brief Función de evaluación usando algoritmo Forward
      */
-    double evaluacion(const std::string& sequence);
+    double evaluacion(const std::string& sequence) const;
+    double evaluacion(const PackedSequence& sequence) const;
+    double evaluacion(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief Log-verosimilitud log P(secuencia) usando Forward escalado
+     */
+    double evaluacion_log(const std::string& sequence) const;
+    double evaluacion_log(const PackedSequence& sequence) const;
+    double evaluacion_log(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief Log-verosimilitud calculada con varios hilos
+     *
+     * La recursión forward es un producto de matrices N x N, una por base.
+     * Cada hilo multiplica (escaladas) las matrices de un tramo de la
+     * secuencia y luego se combinan los productos en orden. Coincide con
+     * evaluacion_log() salvo por redondeo. Usa getNumThreads() hilos; las
+     * secuencias cortas se evalúan en serie.
+     */
+    double evaluacion_log_paralela(const std::string& sequence) const;
+    double evaluacion_log_paralela(const PackedSequence& sequence) const;
+
+    /**
+     * @brief Precalcula las matrices de transferencia de los 4^k k-mers
+     *
+     * Después, evaluacion_log_kmers() y puntuacion_viterbi_kmers() avanzan k
+     * bases por paso usando los 2k bits de cada k-mer de la PackedSequence
+     * como índice en la tabla, en lugar de k pasos de una base. Las tablas
+     * ocupan 2 * 4^k * N * N doubles; k debe estar entre 1 y 8 y el modelo
+     * debe tener los símbolos A, C, G y T. Se descartan al cambiar el
+     * modelo (entrenamiento). Modifica el analizador: no debe usarse desde
+     * otros hilos mientras tanto.
+     */
+    void preparar_kmers(int k);
+
+    /**
+     * @brief k de las tablas de preparar_kmers() (0 si no hay tablas)
+     */
+    int getKmerLength() const;
+
+    /**
+     * @brief evaluacion_log() avanzando k bases por paso
+     *
+     * Coincide con evaluacion_log() salvo por redondeo. Los k-mers con
+     * alguna N y las últimas bases que no completan un k-mer se avanzan
+     * base a base; sin tablas equivale a evaluacion_log().
+     */
+    double evaluacion_log_kmers(const std::string& sequence) const;
+    double evaluacion_log_kmers(const PackedSequence& sequence) const;
+
+    /**
+     * @brief log P del mejor camino de Viterbi avanzando k bases por paso
+     *
+     * Da ReconocimientoCompacto::log_probabilidad (salvo por redondeo) sin
+     * guardar punteros ni reconstruir el camino, para puntuar secuencias.
+     */
+    double puntuacion_viterbi_kmers(const std::string& sequence) const;
+    double puntuacion_viterbi_kmers(const PackedSequence& sequence) const;
+
+    /**
+     * @brief Forward escalado que devuelve log P y los coeficientes de escala
+     */
+    ForwardEscaladoResult forward_escalado(const std::string& sequence) const;
+    ForwardEscaladoResult forward_escalado(const PackedSequence& sequence) const;
+
+    /**
+     * @brief Probabilidades posteriores P(estado_t | secuencia) con
+     * Forward-Backward escalado
+     *
+     * A diferencia de ReconocimientoResult::probabilidades (proporción de
+     * la puntuación de Viterbi en cada columna), son posteriores reales y
+     * sirven para filtrar por confianza. Las columnas forward se guardan
+     * directamente en la matriz del resultado y la pasada backward las
+     * convierte en posteriores sin memoria adicional salvo los n
+     * coeficientes de escala.
+     */
+    PosteriorResult decodificacion_posterior(const std::string& sequence) const;
+    PosteriorResult decodificacion_posterior(const PackedSequence& sequence) const;
+    PosteriorResult decodificacion_posterior(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief decodificacion_posterior con puntos de control
+     *
+     * Sólo devuelve el camino posterior y la posterior del estado elegido
+     * (sin la matriz completa), guardando las columnas forward cada k
+     * posiciones y recalculando cada segmento durante la pasada backward.
+     * Mismo camino y probabilidades que decodificacion_posterior(); el
+     * presupuesto se interpreta como en reconocimiento_checkpoint().
+     */
+    PosteriorResult decodificacion_posterior_checkpoint(const std::string& sequence,
+                                                        size_t presupuesto_memoria = 0) const;
+    PosteriorResult decodificacion_posterior_checkpoint(const PackedSequence& sequence,
+                                                        size_t presupuesto_memoria = 0) const;
 
     /**
      * @brief Análisis completo de la secuencia
+     *
+     * Valida la secuencia una vez y calcula el camino de Viterbi y la
+     * probabilidad Forward en la misma pasada; las regiones se obtienen
+     * de los índices de estado.
      */
-    AnalysisResult analizar_regiones(const std::string& sequence);
+    AnalysisResult analizar_regiones(const std::string& sequence) const;
+    AnalysisResult analizar_regiones(const PackedSequence& sequence) const;
+    AnalysisResult analizar_regiones(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief analizar_regiones() sin copiar la secuencia en el resultado
+     *
+     * Las regiones se guardan como posiciones (AnalisisCompacto) y sus
+     * bases se leen de la secuencia recibida, que debe seguir viva
+     * mientras se consulten. Para secuencias largas evita duplicar la
+     * entrada en secuencia y en cada Region::secuencia.
+     */
+    AnalisisCompacto analizar_regiones_compacto(const std::string& sequence) const;
+    AnalisisCompacto analizar_regiones_compacto(const PackedSequence& sequence) const;
+    AnalisisCompacto analizar_regiones_compacto(const char* datos, size_t longitud) const;
+
+    /**
+     * @brief Reconocimiento de muchas lecturas en una sola llamada
+     *
+     * Las lecturas se reparten entre getNumThreads() hilos, cada uno con su
+     * propia memoria de trabajo. Se aceptan como vector de secuencias o como
+     * un buffer concatenado con offsets (offsets.size() = lecturas + 1). Las
+     * variantes con (datos, longitud) leen el buffer del llamador sin copiarlo.
+     */
+    ReconocimientoBatchResult reconocimiento_batch(const std::vector<std::string>& secuencias) const;
+    ReconocimientoBatchResult reconocimiento_batch(const std::string& concatenadas,
+                                                   const std::vector<size_t>& offsets) const;
+    ReconocimientoBatchResult reconocimiento_batch(const char* datos, size_t longitud,
+                                                   const std::vector<size_t>& offsets) const;
+
+    /**
+     * @brief evaluacion / evaluacion_log de muchas lecturas en una sola llamada
+     */
+    std::vector<double> evaluacion_batch(const std::vector<std::string>& secuencias) const;
+    std::vector<double> evaluacion_batch(const std::string& concatenadas,
+                                         const std::vector<size_t>& offsets) const;
+    std::vector<double> evaluacion_log_batch(const std::vector<std::string>& secuencias) const;
+    std::vector<double> evaluacion_log_batch(const std::string& concatenadas,
+                                             const std::vector<size_t>& offsets) const;
+    std::vector<double> evaluacion_log_batch(const char* datos, size_t longitud,
+                                             const std::vector<size_t>& offsets) const;
+
+    /**
+     * @brief analizar_regiones de muchas lecturas en una sola llamada
+     */
+    AnalisisBatchResult analizar_regiones_batch(const std::vector<std::string>& secuencias) const;
+    AnalisisBatchResult analizar_regiones_batch(const std::string& concatenadas,
+                                                const std::vector<size_t>& offsets) const;
+    AnalisisBatchResult analizar_regiones_batch(const char* datos, size_t longitud,
+                                                const std::vector<size_t>& offsets) const;
+
+    /**
+     * @brief Ajusta start_prob, trans_prob y emit_prob con Baum-Welch (EM)
+     *
+     * Cada iteración calcula los conteos esperados con Forward-Backward
+     * escalado, repartiendo las lecturas entre getNumThreads() hilos; las
+     * lecturas largas se dividen en tramos cuyas columnas de frontera se
+     * obtienen con los productos de matrices de evaluacion_log_paralela().
+     * Los conteos de cada tarea se suman en un orden fijo, así que el
+     * resultado no depende del número de hilos. Se
+     * para tras max_iteraciones o cuando la mejora relativa de la
+     * log-verosimilitud es menor que tolerancia. Las filas sin conteos
+     * conservan sus valores. Modifica el modelo: no debe usarse el
+     * analizador desde otros hilos mientras tanto.
+     */
+    EntrenamientoResult entrenar_baum_welch(const std::vector<std::string>& secuencias,
+                                            int max_iteraciones = 100, double tolerancia = 1e-6);
+    EntrenamientoResult entrenar_baum_welch(const std::string& concatenadas, const std::vector<size_t>& offsets,
+                                            int max_iteraciones = 100, double tolerancia = 1e-6);
+
+    /**
+     * @brief Entrenamiento de Viterbi (EM duro): más barato que Baum-Welch
+     *
+     * En cada iteración se decodifica cada lectura con el algoritmo de
+     * reconocimiento() (sin calcular probabilidades; las lecturas largas
+     * con Viterbi paralelo) y los parámetros se reestiman con los conteos
+     * del mejor camino más pseudoconteo en cada casilla, para que ninguna
+     * transición o emisión quede a 0. Termina cuando los caminos no cambian,
+     * cuando la mejora relativa es menor que tolerancia o tras
+     * max_iteraciones. log_verosimilitudes guarda la suma de log P del
+     * mejor camino de cada lectura; para las lecturas largas se suma a lo
+     * largo del camino, en orden, de modo que el resultado y la iteración
+     * en la que se para no dependen del número de hilos. Útil como punto
+     * de partida de entrenar_baum_welch().
+     */
+    EntrenamientoResult entrenar_viterbi(const std::vector<std::string>& secuencias, int max_iteraciones = 100,
+                                         double tolerancia = 1e-6, double pseudoconteo = 1.0);
+    EntrenamientoResult entrenar_viterbi(const std::string& concatenadas, const std::vector<size_t>& offsets,
+                                         int max_iteraciones = 100, double tolerancia = 1e-6,
+                                         double pseudoconteo = 1.0);
 
     // Métodos getter para acceder a los parámetros del modelo
     std::vector<std::string> getStates() const;
@@ -98,6 +704,97 @@ public:
     std::map<std::string, double> getStartProbabilities() const;
     std::map<std::string, std::map<std::string, double>> getTransitionProbabilities() const;
     std::map<std::string, std::map<std::string, double>> getEmissionProbabilities() const;
+    const CompiledModel& getCompiledModel() const;
+
+    /**
+     * @brief Número de hilos de los métodos paralelos (por defecto, los del sistema)
+     *
+     * Los hilos salen de un pool persistente compartido por todos los
+     * analizadores, que crece hasta el mayor valor usado; cada llamada
+     * paralela no crea hilos nuevos.
+     */
+    int getNumThreads() const;
+    void setNumThreads(int threads);
+};
+
+/**
+ * @brief Decodificador de Viterbi incremental para secuencias que llegan
+ * por fragmentos (pipes, secuenciadores)
+ *
+ * Cada vez que los caminos supervivientes de todos los estados coinciden
+ * en una posición, los estados hasta esa posición ya no pueden cambiar y
+ * se publican junto con las regiones que se cierran. El resultado sobre
+ * la secuencia concatenada es idéntico al de reconocimiento() y
+ * analizar_regiones(). La memoria depende de la distancia hasta el punto
+ * de coincidencia y de la longitud de la región abierta.
+ */
+class StreamingViterbi {
+private:
+    CompiledModel model;
+    std::vector<std::string> states;
+    size_t max_latency;
+    size_t received;
+    size_t emitted;
+    bool finished;
+    double log_prob;
+    ScaleAccumulator forward_scale;
+
+    std::vector<double> prev, curr, forward_prev, forward_curr;
+    std::vector<int> backptr;
+
+    // Posiciones pendientes [emitted, received): punteros, columnas y bases
+    size_t window_offset;
+    std::vector<unsigned char> window_ptrs;
+    std::vector<double> window_columns;
+    std::string window_bases;
+
+    // Resultados finalizados que aún no se han recogido
+    std::vector<unsigned char> out_states;
+    std::vector<double> out_probs;
+    std::vector<Region> out_regions;
+
+    int region_state;
+    size_t region_start;
+    std::string region_bases;
+
+    void process(const char* data, size_t length);
+    void flush(bool force);
+    void emitUntil(size_t last, int state);
+    void closeRegion(size_t end);
+
+public:
+    /**
+     * @param max_latencia Si es mayor que 0, limita el número de posiciones
+     *        pendientes: al superarlo se fijan las más antiguas siguiendo el
+     *        mejor camino actual. El resultado deja de ser exacto en ese caso.
+     */
+    StreamingViterbi(const HMM_DNA_Analyzer& analyzer, size_t max_latencia = 0);
+
+    void agregar(const std::string& fragmento);
+    void agregar(const char* datos, size_t longitud);
+
+    /**
+     * @brief Marca el final de la secuencia y publica las posiciones pendientes
+     */
+    void finalizar();
+
+    /**
+     * @brief Estados y probabilidades finalizados desde la última llamada
+     */
+    ReconocimientoResult tomar_estados();
+
+    /**
+     * @brief Regiones cerradas desde la última llamada, en orden de posición
+     */
+    std::vector<Region> tomar_regiones();
+
+    size_t posiciones_recibidas() const;
+    size_t posiciones_finalizadas() const;
+    size_t posiciones_pendientes() const;
+
+    // Válidos después de finalizar()
+    double log_probabilidad() const;
+    double log_verosimilitud() const;
 };
 
 // Funciones globales simplificadas
@@ -109,4 +806,6 @@ void reconocimiento_global_output(const std::string& sequence,
 
 double evaluacion_global(const std::string& sequence);
 
+double evaluacion_log_global(const std::string& sequence);
+
 #endif // HMM_DNA_ANALYZER_H
\ No newline at end of file
@@ -3,11 +3,97 @@
 
 %{
 #include "HMMmethods.h"
+#include "HMMio.h"
+
+// Exportador mínimo del buffer protocol: expone un bloque contiguo de un
+// resultado C++ sin copiarlo y mantiene vivo el objeto Python que lo posee
+// (el proxy SWIG del resultado) mientras exista alguna vista.
+struct HMMBufferObject {
+    PyObject_HEAD
+    PyObject* owner;
+    void* data;
+    Py_ssize_t count;
+    Py_ssize_t itemsize;
+    const char* format;
+};
+
+// Sin inicializador (todo a cero): los campos se rellenan en %init
+static PyTypeObject HMMBufferType;
+
+static int HMMBuffer_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    HMMBufferObject* buffer = (HMMBufferObject*)self;
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "El resultado es de solo lectura");
+        view->obj = NULL;
+        return -1;
+    }
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = buffer->data;
+    view->len = buffer->count * buffer->itemsize;
+    view->readonly = 1;
+    view->itemsize = buffer->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? (char*)buffer->format : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &buffer->count : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &buffer->itemsize : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static void HMMBuffer_dealloc(PyObject* self) {
+    Py_XDECREF(((HMMBufferObject*)self)->owner);
+    PyObject_Del(self);
+}
+
+static PyBufferProcs HMMBufferProcs = { HMMBuffer_getbuffer, NULL };
+
+// memoryview de solo lectura sobre [data, data + count) que referencia a owner
+static PyObject* HMMBuffer_view(PyObject* owner, const void* data, size_t count,
+                                size_t itemsize, const char* format) {
+    static char empty = 0;
+    HMMBufferObject* buffer = PyObject_New(HMMBufferObject, &HMMBufferType);
+    if (!buffer) return NULL;
+    Py_INCREF(owner);
+    buffer->owner = owner;
+    buffer->data = count ? const_cast<void*>(data) : &empty;
+    buffer->count = (Py_ssize_t)count;
+    buffer->itemsize = (Py_ssize_t)itemsize;
+    buffer->format = format;
+    PyObject* view = PyMemoryView_FromObject((PyObject*)buffer);
+    Py_DECREF(buffer);
+    return view;
+}
+
+// Argumento (datos, longitud) tomado de cualquier objeto con buffer protocol
+// (bytes, bytearray, memoryview, numpy.uint8...). El buffer se libera al
+// salir del wrapper, con el GIL ya recuperado.
+struct HMMBufferArg {
+    Py_buffer view;
+    bool acquired;
+    HMMBufferArg() : acquired(false) {}
+    ~HMMBufferArg() { if (acquired) PyBuffer_Release(&view); }
+};
+%}
+
+%init %{
+    // Un tipo estático empieza con una referencia; PyType_Ready pone ob_type
+    Py_INCREF((PyObject*)&HMMBufferType);
+    HMMBufferType.tp_name = "HMMmethodsDynamic.HMMBuffer";
+    HMMBufferType.tp_basicsize = sizeof(HMMBufferObject);
+    HMMBufferType.tp_dealloc = HMMBuffer_dealloc;
+    HMMBufferType.tp_as_buffer = &HMMBufferProcs;
+    HMMBufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+    if (PyType_Ready(&HMMBufferType) < 0) {
+        return NULL;
+    }
 %}
 
 %include "std_vector.i"
 %include "std_string.i"
 %include "std_map.i"
+%include "stdint.i"
 %include "exception.i"
 
 // Manejo de excepciones
@@ -19,11 +105,228 @@
     }
 }
 
+// Métodos que liberan el GIL mientras corre el código C++. Sólo leen el
+// modelo, que se considera inmutable durante la llamada: no se deben
+// modificar parámetros del analizador (p. ej. setNumThreads) desde otro
+// hilo mientras tanto.
+%define HMM_RELEASE_GIL(function)
+%exception function {
+    try {
+        PyThreadState* _save = PyEval_SaveThread();
+        try {
+            $action
+        } catch (...) {
+            PyEval_RestoreThread(_save);
+            throw;
+        }
+        PyEval_RestoreThread(_save);
+    } catch (const std::exception& e) {
+        SWIG_exception(SWIG_RuntimeError, e.what());
+    }
+}
+%enddef
+
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::reconocimiento)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::reconocimiento_compacto)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::reconocimiento_checkpoint)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::reconocimiento_paralelo)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::reconocimiento_output)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::evaluacion)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::evaluacion_log)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::evaluacion_log_paralela)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::evaluacion_log_kmers)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::puntuacion_viterbi_kmers)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::forward_escalado)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::decodificacion_posterior)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::decodificacion_posterior_checkpoint)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::analizar_regiones)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::analizar_regiones_compacto)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::reconocimiento_batch)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::evaluacion_batch)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::evaluacion_log_batch)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::analizar_regiones_batch)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::entrenar_baum_welch)
+HMM_RELEASE_GIL(HMM_DNA_Analyzer::entrenar_viterbi)
+HMM_RELEASE_GIL(PackedSequence::PackedSequence)
+HMM_RELEASE_GIL(MappedFasta::MappedFasta)
+HMM_RELEASE_GIL(MappedFasta::empaquetar)
+HMM_RELEASE_GIL(MappedFasta::secuencia)
+HMM_RELEASE_GIL(ReadPipeline::siguiente)
+HMM_RELEASE_GIL(ReadPipeline::~ReadPipeline)
+HMM_RELEASE_GIL(RegionWriter::escribir)
+HMM_RELEASE_GIL(RegionWriter::cerrar)
+HMM_RELEASE_GIL(ResultWriter::escribir)
+HMM_RELEASE_GIL(ResultWriter::cerrar)
+HMM_RELEASE_GIL(MappedResults::MappedResults)
+HMM_RELEASE_GIL(MappedResults::codigos)
+HMM_RELEASE_GIL(MappedResults::regiones)
+HMM_RELEASE_GIL(reconocimiento_global)
+HMM_RELEASE_GIL(reconocimiento_global_output)
+HMM_RELEASE_GIL(evaluacion_global)
+HMM_RELEASE_GIL(evaluacion_log_global)
+
+// Secuencias como buffer (bytes, bytearray, memoryview, numpy) sin copiarlas
+// a un str de Python. Los str siguen yendo por las sobrecargas std::string.
+%typemap(in) (const char* datos, size_t longitud) (HMMBufferArg buffer) {
+    if (PyObject_GetBuffer($input, &buffer.view, PyBUF_SIMPLE) != 0) {
+        SWIG_fail;
+    }
+    buffer.acquired = true;
+    $1 = (char*)buffer.view.buf;
+    $2 = (size_t)buffer.view.len;
+}
+%typemap(typecheck, precedence=SWIG_TYPECHECK_CHAR_PTR) (const char* datos, size_t longitud) {
+    $1 = PyObject_CheckBuffer($input) ? 1 : 0;
+}
+%apply (const char* datos, size_t longitud) { (const char* data, size_t length) };
+
+// Vistas sin copia de los resultados (memoryview de solo lectura; válidas
+// mientras no se modifique el resultado). Con NumPy: numpy.asarray(vista).
+%extend ReconocimientoResult {
+    PyObject* _vista_codigos(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->codigos.data(), $self->codigos.size(), 1, "B");
+    }
+    PyObject* _vista_probabilidades(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->probabilidades.data(), $self->probabilidades.size(), sizeof(double), "d");
+    }
+    %pythoncode %{
+    def codigos_array(self):
+        """Índices de estado por posición (uint8), sin copia."""
+        return self._vista_codigos(self)
+
+    def probabilidades_array(self):
+        """Probabilidades por posición (float64), sin copia."""
+        return self._vista_probabilidades(self)
+    %}
+}
+
+%extend ReconocimientoCompacto {
+    PyObject* _vista_codigos(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->codigos.data(), $self->codigos.size(), 1, "B");
+    }
+    PyObject* _vista_probabilidades(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->probabilidades.data(), $self->probabilidades.size(), sizeof(double), "d");
+    }
+    %pythoncode %{
+    def codigos_array(self):
+        """Índices de estado por posición (uint8), sin copia."""
+        return self._vista_codigos(self)
+
+    def probabilidades_array(self):
+        """Probabilidades por posición (float64), sin copia."""
+        return self._vista_probabilidades(self)
+    %}
+}
+
+%extend PosteriorResult {
+    PyObject* _vista_posteriores(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->posteriores.data(), $self->posteriores.size(), sizeof(double), "d");
+    }
+    PyObject* _vista_codigos(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->codigos.data(), $self->codigos.size(), 1, "B");
+    }
+    PyObject* _vista_probabilidades(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->probabilidades.data(), $self->probabilidades.size(), sizeof(double), "d");
+    }
+    %pythoncode %{
+    def posteriores_array(self):
+        """Matriz de posteriores (posición x estado, float64), sin copia."""
+        vista = self._vista_posteriores(self)
+        if len(vista) == 0:
+            return vista
+        return vista.cast("B").cast("d", (self.size(), len(self.nombres_estados)))
+
+    def codigos_array(self):
+        """Estado de mayor posterior por posición (uint8), sin copia."""
+        return self._vista_codigos(self)
+
+    def probabilidades_array(self):
+        """Posterior del estado elegido por posición (float64), sin copia."""
+        return self._vista_probabilidades(self)
+    %}
+}
+
+%extend ForwardEscaladoResult {
+    PyObject* _vista_coeficientes(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->coeficientes.data(), $self->coeficientes.size(), sizeof(double), "d");
+    }
+    %pythoncode %{
+    def coeficientes_array(self):
+        """Coeficientes de escala (float64), sin copia."""
+        return self._vista_coeficientes(self)
+    %}
+}
+
+%define HMM_BATCH_VIEWS(Result)
+%extend Result {
+    PyObject* _vista_estados(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->estados.data(), $self->estados.size(), 1, "B");
+    }
+    PyObject* _vista_probabilidades(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->probabilidades.data(), $self->probabilidades.size(), sizeof(double), "d");
+    }
+    PyObject* _vista_log_probabilidades(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->log_probabilidades.data(), $self->log_probabilidades.size(), sizeof(double), "d");
+    }
+    PyObject* _vista_offsets(PyObject* owner) const {
+        return HMMBuffer_view(owner, $self->offsets.data(), $self->offsets.size(), sizeof(size_t), sizeof(size_t) == 8 ? "Q" : "I");
+    }
+    %pythoncode %{
+    def estados_array(self):
+        """Índices de estado concatenados de todas las lecturas (uint8), sin copia."""
+        return self._vista_estados(self)
+
+    def probabilidades_array(self):
+        """Probabilidades por posición concatenadas (float64), sin copia."""
+        return self._vista_probabilidades(self)
+
+    def log_probabilidades_array(self):
+        """log P del mejor camino de cada lectura (float64), sin copia."""
+        return self._vista_log_probabilidades(self)
+
+    def offsets_array(self):
+        """Offsets de cada lectura en los arrays concatenados, sin copia."""
+        return self._vista_offsets(self)
+    %}
+}
+%enddef
+
+HMM_BATCH_VIEWS(ReconocimientoBatchResult)
+HMM_BATCH_VIEWS(AnalisisBatchResult)
+
+// Representación interna del modelo, no se expone a Python
+%ignore CompiledModel;
+%ignore ScaleAccumulator;
+%ignore KmerTables;
+%ignore HMM_DNA_Analyzer::getCompiledModel;
+%ignore PackedSequence::wordData;
+%ignore PackedSequence::nMaskData;
+
+// AnalisisCompacto lee las bases de la secuencia analizada: desde Python
+// sólo se admiten buffers (bytes, bytearray, memoryview...) y
+// PackedSequence (un str se convertiría en un std::string temporal) y el
+// resultado guarda una referencia a ella
+%ignore HMM_DNA_Analyzer::analizar_regiones_compacto(const std::string&) const;
+%ignore AnalisisCompacto::datos;
+%ignore AnalisisCompacto::empaquetada;
+%ignore AnalisisCompacto::bases;
+// Con un buffer se guarda una memoryview, no el objeto: mientras viva el
+// resultado el buffer sigue exportado y un bytearray no puede cambiar de
+// tamaño (ni liberar o mover las bases a las que apunta datos)
+%pythonappend HMM_DNA_Analyzer::analizar_regiones_compacto %{
+    val._secuencia = args[0] if isinstance(args[0], PackedSequence) else memoryview(args[0])
+%}
+
 // Templates para los tipos que se usan
 %template(StringVector) std::vector<std::string>;
 %template(DoubleVector) std::vector<double>;
+%template(IntVector) std::vector<int>;
+%template(SizeVector) std::vector<size_t>;
+%template(ByteVector) std::vector<unsigned char>;
 %template(RegionVector) std::vector<Region>;
+%template(RegionCompactaVector) std::vector<RegionCompacta>;
 %template(StringDoubleMap) std::map<std::string, double>;
 %template(StringStringDoubleMap) std::map<std::string, std::map<std::string, double>>;
 
-%include "HMMmethods.h"
\ No newline at end of file
+%include "HMMmethods.h"
+%include "HMMio.h"
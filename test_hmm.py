@@ -1,3 +1,9 @@
+import gzip
+import os
+import tempfile
+import zlib
+from concurrent.futures import ThreadPoolExecutor
+
 try:
     import HMMmethodsDynamic
 
@@ -78,6 +84,247 @@ try:
     long_prob_total = analyzer.evaluacion(long_sequence)
     print(f"Probabilidad total: {long_prob_total:.8f}")
 
+    # Log-verosimilitud: no sufre underflow en secuencias largas
+    print("\n=== LOG-VEROSIMILITUD ===")
+    very_long_sequence = "ATGCGGCATTACG" * 1000
+    print(f"Longitud: {len(very_long_sequence)}")
+    print(f"Probabilidad total: {analyzer.evaluacion(very_long_sequence)}")
+    print(f"Log-verosimilitud: {analyzer.evaluacion_log(very_long_sequence):.6f}")
+
+    very_long_result = analyzer.reconocimiento(very_long_sequence)
+    print(f"Log P del mejor camino: {very_long_result.log_probabilidad:.6f}")
+
+    scaled = analyzer.forward_escalado(long_sequence)
+    print(f"Coeficientes de escala: {[f'{c:.4f}' for c in scaled.coeficientes]}")
+
+    # Secuencia empaquetada a 2 bits por base, reutilizable entre análisis
+    print("\n=== SECUENCIA EMPAQUETADA ===")
+    packed = HMMmethodsDynamic.PackedSequence(very_long_sequence)
+    print(f"Bases: {packed.size()}, bytes: {packed.memoryBytes()}")
+    print(f"Log-verosimilitud: {analyzer.evaluacion_log(packed):.6f}")
+    print(f"Log-verosimilitud (paralela, {analyzer.getNumThreads()} hilos): "
+          f"{analyzer.evaluacion_log_paralela(packed):.6f}")
+    packed_result = analyzer.reconocimiento(packed)
+    print(f"Log P del mejor camino: {packed_result.log_probabilidad:.6f}")
+
+    # Viterbi con puntos de control: mismo camino con memoria O(sqrt(n))
+    print("\n=== VITERBI CON PUNTOS DE CONTROL ===")
+    ckpt_result = analyzer.reconocimiento_checkpoint(packed, 64 * 1024)
+    same_path = list(ckpt_result.estados) == list(packed_result.estados)
+    print(f"Mismo camino que reconocimiento: {same_path}")
+
+    parallel_result = analyzer.reconocimiento_paralelo(packed)
+    same_path = list(parallel_result.estados) == list(packed_result.estados)
+    print(f"Mismo camino con Viterbi paralelo: {same_path}")
+
+    # Decodificación por fragmentos con publicación incremental
+    print("\n=== VITERBI EN STREAMING ===")
+    decoder = HMMmethodsDynamic.StreamingViterbi(analyzer)
+    streamed = []
+    streamed_codes = []
+    for start in range(0, len(long_sequence), 5):
+        decoder.agregar(long_sequence[start : start + 5])
+        chunk = decoder.tomar_estados()
+        streamed.extend(chunk.estados)
+        streamed_codes.extend(chunk.codigos)
+        print(f"Recibidas: {decoder.posiciones_recibidas()}, pendientes: {decoder.posiciones_pendientes()}")
+    decoder.finalizar()
+    chunk = decoder.tomar_estados()
+    streamed.extend(chunk.estados)
+    streamed_codes.extend(chunk.codigos)
+    print(f"Estados: {streamed}")
+    print(f"Igual a reconocimiento: {streamed == long_estados}")
+    print(f"Códigos iguales a los estados: "
+          f"{[analyzer.getStates()[c] for c in streamed_codes] == streamed}")
+    for region in decoder.tomar_regiones():
+        print(f"  {region.tipo}: pos {region.inicio}-{region.fin}, secuencia: {region.secuencia}")
+
+    # Muchas lecturas en una sola llamada
+    print("\n=== LECTURAS EN BATCH ===")
+    reads = HMMmethodsDynamic.StringVector([sequence, long_sequence, "GGGCCCAAATTT"])
+    batch = analyzer.reconocimiento_batch(reads)
+    for r in range(len(reads)):
+        codes = batch.estados[batch.offsets[r] : batch.offsets[r + 1]]
+        print(f"Lectura {r}: {''.join(batch.nombres_estados[c] for c in codes)}, "
+              f"log P: {batch.log_probabilidades[r]:.4f}")
+    print(f"Log-verosimilitudes: {[f'{p:.4f}' for p in analyzer.evaluacion_log_batch(reads)]}")
+
+    regions_batch = analyzer.analizar_regiones_batch(reads)
+    print(f"Regiones por lectura: {[regions_batch.region_offsets[r + 1] - regions_batch.region_offsets[r] for r in range(len(reads))]}")
+
+    # Estados como índices de 1 byte, etiquetas solo bajo demanda
+    print("\n=== RECONOCIMIENTO COMPACTO ===")
+    compact = analyzer.reconocimiento_compacto(long_sequence)
+    bounds = compact.tramos()
+    print(f"Posiciones: {compact.size()}, tramos: {len(bounds) - 1}, "
+          f"estados iguales: {list(compact.estados()) == list(analyzer.reconocimiento(long_sequence).estados)}")
+    print(f"Primeros tramos: {[(bounds[k], compact.nombres_estados[compact.codigos[bounds[k]]]) for k in range(min(5, len(bounds) - 1))]}")
+
+    # Posteriores reales P(estado_t | secuencia) con Forward-Backward
+    print("\n=== DECODIFICACIÓN POSTERIOR ===")
+    posterior = analyzer.decodificacion_posterior(long_sequence)
+    print(f"Estados: {list(posterior.estados())}")
+    print(f"Posteriores: {[f'{p:.3f}' for p in posterior.probabilidades]}")
+    print(f"P(H) en la posición 0: {posterior.posterior(0, 0):.4f}, "
+          f"log P: {posterior.log_verosimilitud:.6f}")
+    posterior_ckpt = analyzer.decodificacion_posterior_checkpoint(packed, 64 * 1024)
+    same_path = list(posterior_ckpt.codigos) == list(analyzer.decodificacion_posterior(packed).codigos)
+    print(f"Mismo camino con puntos de control: {same_path}")
+
+    # Ajuste de los parámetros a un corpus con Baum-Welch (en un analizador aparte)
+    print("\n=== ENTRENAMIENTO BAUM-WELCH ===")
+    trained = HMMmethodsDynamic.HMM_DNA_Analyzer()
+    corpus = HMMmethodsDynamic.StringVector(["GGCGCCGCGGATATTAATTA" * 20, "ATATTTAAGCGCGGCC" * 30, very_long_sequence])
+    training = trained.entrenar_baum_welch(corpus, 50, 1e-6)
+    print(f"Iteraciones: {training.iteraciones}, convergido: {training.convergido}")
+    print(f"Log-verosimilitud: {training.log_verosimilitudes[0]:.4f} -> {training.log_verosimilitudes[len(training.log_verosimilitudes) - 1]:.4f}")
+    print(f"Transiciones: {dict((k, dict(v)) for k, v in trained.getTransitionProbabilities().items())}")
+
+    viterbi_trained = HMMmethodsDynamic.HMM_DNA_Analyzer()
+    training = viterbi_trained.entrenar_viterbi(corpus)
+    print(f"Entrenamiento de Viterbi: {training.iteraciones} iteraciones, convergido: {training.convergido}")
+
+    # Resultados como memoryview sobre la memoria C++ y secuencias como bytes
+    print("\n=== BUFFERS SIN COPIA ===")
+    result_bytes = analyzer.reconocimiento(long_sequence.encode())
+    codes = result_bytes.codigos_array()
+    print(f"Códigos: {codes.format} x {len(codes)}, "
+          f"iguales a str: {list(codes) == list(analyzer.reconocimiento(long_sequence).codigos)}")
+    print(f"Probabilidades: {result_bytes.probabilidades_array().format} x {len(result_bytes.probabilidades_array())}")
+    concatenated = (sequence + long_sequence).encode()
+    offsets = HMMmethodsDynamic.SizeVector([0, len(sequence), len(concatenated)])
+    batch_bytes = analyzer.reconocimiento_batch(memoryview(concatenated), offsets)
+    print(f"Estados batch: {len(batch_bytes.estados_array())}, "
+          f"log P: {[f'{p:.4f}' for p in batch_bytes.log_probabilidades_array()]}")
+
+    # Modelo arbitrario de 3 estados y 2 símbolos, guardado y cargado en JSON
+    print("\n=== MODELO CONFIGURABLE ===")
+    custom = HMMmethodsDynamic.HMM_DNA_Analyzer(
+        ["E1", "E2", "E3"], ["x", "y"], [0.5, 0.3, 0.2],
+        [0.8, 0.1, 0.1, 0.2, 0.7, 0.1, 0.3, 0.3, 0.4],
+        [0.9, 0.1, 0.5, 0.5, 0.1, 0.9])
+    print(f"Estados: {list(custom.reconocimiento('xxxyyyxyyyyy').estados)}")
+    model_path = os.path.join(tempfile.mkdtemp(), "modelo.json")
+    HMMmethodsDynamic.guardar_modelo_json(custom, model_path)
+    loaded = HMMmethodsDynamic.cargar_modelo(model_path)
+    print(f"Misma log-verosimilitud tras cargar: "
+          f"{loaded.evaluacion_log('xxxyyyxyyyyy') == custom.evaluacion_log('xxxyyyxyyyyy')}")
+
+    # Regiones como posiciones: las bases se leen de la secuencia al pedirlas
+    print("\n=== REGIONES SIN COPIA ===")
+    sequence_bytes = long_sequence.encode()
+    compact_analysis = analyzer.analizar_regiones_compacto(sequence_bytes)
+    print(f"Regiones: {[(r.inicio, r.fin, compact_analysis.nombres_estados[r.estado]) for r in compact_analysis.regiones]}")
+    full_analysis = analyzer.analizar_regiones(long_sequence)
+    full_regions = sorted((r.inicio, r.tipo, r.secuencia) for r in
+                          list(full_analysis.regiones_codificantes) + list(full_analysis.regiones_no_codificantes))
+    compact_regions = [(r.inicio, r.tipo, r.secuencia) for r in
+                       (compact_analysis.region(i) for i in range(len(compact_analysis.regiones)))]
+    print(f"Mismas regiones que analizar_regiones: {compact_regions == full_regions}")
+    mutable_sequence = bytearray(sequence_bytes)
+    mutable_analysis = analyzer.analizar_regiones_compacto(mutable_sequence)
+    try:
+        mutable_sequence.clear()
+        print("bytearray vaciado con el resultado vivo")
+    except BufferError:
+        print(f"El bytearray no cambia de tamaño mientras vive el resultado: "
+              f"{mutable_analysis.secuencia(0) == compact_analysis.secuencia(0)}")
+
+    # FASTA proyectado en memoria: cada registro se empaqueta sin saltos de línea
+    print("\n=== FASTA PROYECTADO EN MEMORIA ===")
+    fasta_path = os.path.join(tempfile.mkdtemp(), "lecturas.fa")
+    with open(fasta_path, "w") as fasta_file:
+        fasta_file.write(">r1 primera\nATGCGGCA\nTTACG\n>r2\nGGCATT\n")
+    fasta = HMMmethodsDynamic.MappedFasta(fasta_path)
+    for i in range(fasta.num_registros()):
+        record = fasta.registro(i)
+        print(f"{record.nombre}: {record.longitud} bases, "
+              f"log-verosimilitud {analyzer.evaluacion_log(fasta.empaquetar(i)):.6f}")
+    fasta.guardar_indice(fasta_path + ".fai")
+    print(f"Con índice .fai: {HMMmethodsDynamic.MappedFasta(fasta_path).secuencia(fasta.buscar('r1'))}")
+
+    # FASTQ comprimido leído y analizado por bloques en paralelo
+    print("\n=== FASTQ COMPRIMIDO ===")
+    fastq_path = os.path.join(tempfile.mkdtemp(), "lecturas.fq.gz")
+    with gzip.open(fastq_path, "wt") as fastq_file:
+        for i, read in enumerate([sequence, long_sequence, "GGGCCCAAATTT"]):
+            fastq_file.write(f"@lectura{i}\n{read}\n+\n{'I' * len(read)}\n")
+    pipeline = HMMmethodsDynamic.ReadPipeline(analyzer, fastq_path, True, 16)
+    block = HMMmethodsDynamic.BloqueLecturas()
+    while pipeline.siguiente(block):
+        print(f"Bloque desde la lectura {block.primera_lectura}: "
+              f"{[(block.nombres[r], round(block.log_verosimilitudes[r], 4)) for r in range(block.size())]}")
+
+    # Un gzip cortado (sin el final del stream) es un error, no un archivo más corto
+    truncated_path = os.path.join(tempfile.mkdtemp(), "cortado.fq.gz")
+    compressor = zlib.compressobj(6, zlib.DEFLATED, 31)
+    with open(truncated_path, "wb") as truncated_file:
+        truncated_file.write(compressor.compress(b"@r0\nACGTACGT\n+\nIIIIIIII\n") +
+                             compressor.flush(zlib.Z_FULL_FLUSH))
+    try:
+        pipeline = HMMmethodsDynamic.ReadPipeline(analyzer, truncated_path, True)
+        while pipeline.siguiente(block):
+            pass
+        print("gzip truncado: sin error")
+    except RuntimeError as e:
+        print(f"gzip truncado: {e}")
+
+    # Las lecturas con N o vacías se marcan como rechazadas sin detener el archivo
+    masked_path = os.path.join(tempfile.mkdtemp(), "con_n.fq.gz")
+    with gzip.open(masked_path, "wt") as fastq_file:
+        fastq_file.write("@con_n\nACGTNNACGT\n+\nIIIIIIIIII\n@minusculas\nacgtGGCA\n+\nIIIIIIII\n")
+    pipeline = HMMmethodsDynamic.ReadPipeline(analyzer, masked_path)
+    while pipeline.siguiente(block):
+        print(f"Rechazadas: {[block.nombres[r] for r in block.rechazadas]}, "
+              f"log P de minusculas igual que en mayúsculas: "
+              f"{abs(block.analisis.log_probabilidades[1] - analyzer.reconocimiento('ACGTGGCA').log_probabilidad) < 1e-9}")
+
+    # Regiones escritas en BED y GFF3 por bloques
+    print("\n=== REGIONES EN BED/GFF3 ===")
+    regions_dir = tempfile.mkdtemp()
+    for extension in ["bed", "gff3"]:
+        regions_path = os.path.join(regions_dir, "regiones." + extension)
+        writer = HMMmethodsDynamic.RegionWriter(regions_path)
+        writer.escribir("chr1", analyzer.decodificacion_posterior(long_sequence), 1000, "+")
+        pipeline = HMMmethodsDynamic.ReadPipeline(analyzer, fastq_path)
+        while pipeline.siguiente(block):
+            writer.escribir(block)
+        writer.cerrar()
+        with open(regions_path) as regions_file:
+            lines = regions_file.read().splitlines()
+        print(f"{extension}: {len(lines)} líneas, primera: {lines[1] if extension == 'gff3' else lines[0]}")
+
+    # Resultados binarios: se reabren proyectados sin volver a decodificar
+    print("\n=== RESULTADOS BINARIOS ===")
+    results_path = os.path.join(tempfile.mkdtemp(), "resultados.hmmr")
+    results_writer = HMMmethodsDynamic.ResultWriter(results_path, analyzer)
+    results_writer.escribir("chr1", compact_analysis)
+    results_writer.escribir("posterior", analyzer.decodificacion_posterior(long_sequence))
+    results_writer.cerrar()
+    results = HMMmethodsDynamic.MappedResults(results_path)
+    chr1 = results.buscar("chr1")
+    print(f"Registros: {[results.nombre(i) for i in range(results.num_registros())]}, "
+          f"compatible: {results.compatible(analyzer)}")
+    print(f"Mismos estados: {list(results.codigos(chr1, 0, results.longitud(chr1))) == list(compact_analysis.codigos)}")
+    print(f"Estado y probabilidad en 10: {results.nombres_estados()[results.estado(chr1, 10)]}, "
+          f"{results.probabilidad(chr1, 10):.3f}")
+    print(f"Regiones en [5, 15): {[(r.inicio, r.fin, r.estado) for r in results.regiones(chr1, 5, 15)]}")
+
+    # Tablas de k-mers: evaluación y puntuación de Viterbi k bases por paso
+    print("\n=== TABLAS DE K-MERS ===")
+    analyzer.preparar_kmers(6)
+    print(f"k: {analyzer.getKmerLength()}")
+    print(f"Log-verosimilitud (k-mers): {analyzer.evaluacion_log_kmers(packed):.6f}")
+    print(f"Log P del mejor camino (k-mers): {analyzer.puntuacion_viterbi_kmers(packed):.6f}")
+
+    # Los métodos liberan el GIL: varias llamadas pueden correr a la vez
+    print("\n=== LLAMADAS CONCURRENTES ===")
+    chunks = [very_long_sequence[i : i + 2000] for i in range(0, len(very_long_sequence), 2000)]
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        concurrent = list(pool.map(analyzer.evaluacion_log, chunks))
+    serial = [analyzer.evaluacion_log(chunk) for chunk in chunks]
+    print(f"Resultados iguales a la ejecución en serie: {concurrent == serial}")
+
     # Probar método con parámetros de salida
     print("\n=== MÉTODO CON PARÁMETROS DE SALIDA ===")
     estados_out = HMMmethodsDynamic.StringVector()